@@ -35,7 +35,9 @@
 #define DHT_DEBUG 0
 
 //If set to 1, will not re trigger a read if attempting to use old readings
+#ifndef NO_AUTOREFRESH
 #define NO_AUTOREFRESH 0
+#endif
 
 /* Your choices are:
  * DHT_CELSIUS: Smallest code size.
@@ -45,6 +47,32 @@
  * */
 #define DHT_TEMPERATURE DHT_RUNTIME
 
+//If set to 1, every read feeds a trend filter that can estimate temperature
+//and humidity at any time between reads. See estimateTempAndHumidity()
+#ifndef DHT_ESTIMATOR
+#define DHT_ESTIMATOR 0
+#endif
+
+/* If set to 1, a DHT11 gets dew point (DEW_ACCURATE_FAST), heat index
+ * (HEAT_NWS) and comfort (default profile) from a flash table computed at
+ * compile time for all its 3621 possible readings. See DHT11Table.h
+ * Costs 14.8KB of flash (table 14484 bytes), makes these calls a single table
+ * read. See extras/host/test_dht11_table.cpp and bench_dht11_table.cpp
+ * */
+#ifndef DHT11_LOOKUP
+#define DHT11_LOOKUP 0
+#endif
+
+/* Scalar type used for dew point, heat index and comfort computations.
+ * 0: float, with expf/logf/powf. Smallest and fastest where double is
+ *    emulated in software (ESP8266) or is the same as float (AVR).
+ * 1: double, as getDewPoint() always computed before.
+ * The static compute methods can be called with either type regardless.
+ * */
+#ifndef DHT_DOUBLE_MATH
+#define DHT_DOUBLE_MATH 0
+#endif
+
 /*************** SYSTEM CONSTANTS ***************/
 
 /*From datasheet: http://www.micro4you.com/files/sensor/DHT11.pdf
@@ -75,11 +103,88 @@
 #define DEW_ACCURATE_FAST 2
 #define DEW_FASTEST 3
 
+#define HEAT_NWS 0
+#define HEAT_STEADMAN 1
+#define HEAT_TABLE 2
+
+/* Trend filter tuning. Process noise (random rate changes) in unit^2/s^3,
+ * measurement variance in unit^2, covering resolution and sensor noise.
+ * Tuned on simulated room traces, see estimateTempAndHumidity() */
+#define ESTIMATOR_TEMP_Q 1e-7f
+#define ESTIMATOR_HUMID_Q 1e-6f
+#define ESTIMATOR_DHT22_TEMP_R 0.003f
+#define ESTIMATOR_DHT22_HUMID_R 0.01f
+#define ESTIMATOR_DHT11_R 0.1f
+#define ESTIMATOR_RATE_VAR 1e-5f
+
+#define TELEMETRY_CSV 0
+#define TELEMETRY_JSON 1
+#define TELEMETRY_INFLUX 2
+
+//Fields for getTelemetry(), OR them together
+#define TELEMETRY_HUMIDITY 0x01
+#define TELEMETRY_TEMPERATURE 0x02
+#define TELEMETRY_HEAT_INDEX 0x04
+#define TELEMETRY_DEW_POINT 0x08
+#define TELEMETRY_COMFORT_RATIO 0x10
+#define TELEMETRY_COMFORT_STATE 0x20
+#define TELEMETRY_ALL 0x3F
+
+//Buffer size that fits any format with all fields
+#define TELEMETRY_MAX_LEN 144
+
 #define WAKEUP_DHT11 18
 #define WAKEUP_DHT22 1
 
+/* Capture scheduling, see DHT::setCaptureScheduling().
+ * Interrupt-off part of a read (DHT22 worst case, all bits '1'), and how much
+ * the wakeup pulse may be stretched to start it at a quiet window start.
+ * Both sensors accept a longer LOW wakeup pulse. */
+#define CAPTURE_DURATION_MS 6
+#define CAPTURE_MAX_WAKEUP_STRETCH_MS 10
+
 #define LAST_VALUE -1
 
+#if DHT_DOUBLE_MATH
+typedef double DHTScalar;
+#else
+typedef float DHTScalar;
+#endif
+
+/* Math functions matching the scalar type, so that float computations never
+ * go through the double versions.
+ * Calls are qualified: avr-libc defines logf etc. as macros for log etc.,
+ * unqualified they would resolve to these members and recurse. */
+template<typename T> struct DHTMath;
+
+template<> struct DHTMath<float>
+{
+	static inline float log(float x) {return ::logf(x);}
+	static inline float log10(float x) {return ::log10f(x);}
+	static inline float pow(float x, float y) {return ::powf(x, y);}
+	static inline float sqrt(float x) {return ::sqrtf(x);}
+	static inline float fabs(float x) {return ::fabsf(x);}
+};
+
+template<> struct DHTMath<double>
+{
+	static inline double log(double x) {return ::log(x);}
+	static inline double log10(double x) {return ::log10(x);}
+	static inline double pow(double x, double y) {return ::pow(x, y);}
+	static inline double sqrt(double x) {return ::sqrt(x);}
+	static inline double fabs(double x) {return ::fabs(x);}
+};
+
+/* Default comfort profile, see the DHT constructor */
+#define COMFORT_TOOHOT_M -0.095f
+#define COMFORT_TOOHOT_B 32.85f
+#define COMFORT_TOOHUMID_M -56.5f
+#define COMFORT_TOOHUMID_B 3981.2f
+#define COMFORT_TOOCOLD_M -0.04175f
+#define COMFORT_TOOCOLD_B 23.476675f
+#define COMFORT_TOODRY_M -77.8f
+#define COMFORT_TOODRY_B 2364.0f
+
 // Reference: http://epb.apogee.net/res/refcomf.asp
 enum ComfortState
 {
@@ -108,6 +213,53 @@ struct TempAndHumidity
 	float humid;
 };
 
+/* One read attempt, as handed to a DHTReadingQueue or DHTReadingSnapshot */
+struct DHTReading
+{
+	unsigned long timeMs; //millis() when the read started
+	uint16_t seq; //incremented on every read attempt
+	ErrorDHT error;
+	uint8_t raw[5]; //frame as received, last byte is the checksum
+	float temp, humid; //*C and %, NAN if the read failed
+};
+
+/* Widest type read and written in one access, for the lock-free
+ * DHTReadingQueue and DHTReadingSnapshot */
+#if defined(__AVR__)
+typedef uint8_t DHTAtomicWord;
+#else
+typedef uint32_t DHTAtomicWord;
+#endif
+
+/* See DHT::setAdaptiveInterval() */
+struct ReadIntervalStats
+{
+	uint32_t reads; //reads of the sensor
+	uint32_t cachedReads; //read requests answered from the cache
+	uint32_t snapBacks; //returns to the minimum interval
+};
+
+/* See DHT::setCaptureScheduling() */
+struct CaptureStats
+{
+	uint32_t captures; //interrupt-off captures of the sensor
+	uint32_t inWindow; //captures that fit in an announced quiet window
+	uint32_t forced; //captures done at the deadline
+	uint32_t deferredCalls; //due read requests answered from the cache
+	uint32_t totalWaitMs; //time from due to capture, summed
+	uint16_t maxWaitMs;
+};
+
+/**
+ * Asked right before an interrupt-off capture
+ * @return - true to defer the capture, ex WiFi or a timer ISR is due
+ */
+typedef bool (*CaptureVetoCallback)(void);
+
+class DHTReadingQueue;
+class DHTReadingSnapshot;
+class DHTRollup;
+
 struct ComfortProfile
 {
 	//Represent the 4 line equations:
@@ -126,16 +278,34 @@ struct ComfortProfile
 	inline bool isTooDry(float temp, float humidity)
 		{return (temp < (humidity * m_tooDry_m + m_tooDry_b));}
 
-	inline float distanceTooHot(float temp, float humidity)
+	template<typename T> inline T distanceTooHot(T temp, T humidity) const
 		{return temp - (humidity * m_tooHot_m + m_tooHot_b);}
-	inline float distanceTooHumid(float temp, float humidity)
+	template<typename T> inline T distanceTooHumid(T temp, T humidity) const
 		{return temp - (humidity * m_tooHumid_m + m_tooHumid_b);}
-	inline float distanceTooCold(float temp, float humidity)
+	template<typename T> inline T distanceTooCold(T temp, T humidity) const
 		{return (humidity * m_tooCold_m + m_tooHCold_b) - temp;}
-	inline float distanceTooDry(float temp, float humidity)
+	template<typename T> inline T distanceTooDry(T temp, T humidity) const
 		{return (humidity * m_tooDry_m + m_tooDry_b) - temp;}
 };
 
+/* Constant rate Kalman filter for one value: tracks the value and its rate
+ * of change from noisy samples taken at irregular times. Times in seconds. */
+struct TrendFilter
+{
+	float m_value, m_rate;
+	//covariance of (value, rate)
+	float m_p00, m_p01, m_p11;
+	//process noise, measurement variance
+	float m_q, m_r;
+
+	void init(float value, float q, float r);
+	void predict(float dt);
+	void update(float value);
+	float variance(float dt) const;
+
+	inline float estimate(float dt) const {return m_value + m_rate * dt;}
+};
+
 class DHT
 {
 public:
@@ -145,6 +315,17 @@ public:
 	static inline float convertCtoF(float c){ return c * 1.8f + 32; }
 	static inline float convertFtoC(float f){ return (f-32)/1.8f; }
 
+	/* Derived values for explicit inputs, in *C, computed with scalar type T
+	 * (float or double). See the matching get* methods for parameters */
+	template<typename T>
+	static T computeHeatIndex(uint8_t algType, T tempCelsius, T percentHumidity);
+	template<typename T>
+	static T computeDewPoint(uint8_t algType, T tempCelsius, T percentHumidity);
+	template<typename T>
+	static T computeComfortRatio(const ComfortProfile& comfort,
+								 ComfortState& destComfStatus,
+								 T tempCelsius, T percentHumidity);
+
 	/*********************** REGULAR METHODS ***********************/
 	/*must be called with an object ex dht.begin()                 */
 
@@ -162,6 +343,13 @@ public:
 		m_lastError = errDHT_Other;
 		m_lastTemp = NAN;
 		m_lastHumid = NAN;
+		m_readSeq = 0;
+		m_pQueue = NULL;
+		m_pSnapshot = NULL;
+		m_pRollup = NULL;
+#if DHT_ESTIMATOR
+		m_bFilterValid = false;
+#endif
 
 		if (DHT11 == m_kSensorType)
 		{
@@ -179,6 +367,22 @@ public:
 			}
 			m_wakeupTimeMs = WAKEUP_DHT22;
 		}
+		m_baseIntervalRead = m_minIntervalRead;
+		m_adaptiveMaxInterval = 0;
+		m_intervalStats.reads = 0;
+		m_intervalStats.cachedReads = 0;
+		m_intervalStats.snapBacks = 0;
+		m_maxDeferMs = 0;
+		m_captureVeto = NULL;
+		m_quietLength = 0;
+		m_bWindowsAnnounced = false;
+		m_bCaptureDue = false;
+		m_captureStats.captures = 0;
+		m_captureStats.inWindow = 0;
+		m_captureStats.forced = 0;
+		m_captureStats.deferredCalls = 0;
+		m_captureStats.totalWaitMs = 0;
+		m_captureStats.maxWaitMs = 0;
 
 		//Set default comfort profile.
 
@@ -191,17 +395,20 @@ public:
 		//On the X axis we have the rel humidity in % and on the Y axis the temperature in *C
 
 		//Too hot line AB
-		m_comfort.m_tooHot_m = -0.095;
-		m_comfort.m_tooHot_b = 32.85;
+		m_comfort.m_tooHot_m = COMFORT_TOOHOT_M;
+		m_comfort.m_tooHot_b = COMFORT_TOOHOT_B;
 		//Too humid line BC
-		m_comfort.m_tooHumid_m =  -56.5;
-		m_comfort.m_tooHumid_b = 3981.2;
+		m_comfort.m_tooHumid_m = COMFORT_TOOHUMID_M;
+		m_comfort.m_tooHumid_b = COMFORT_TOOHUMID_B;
 		//Too cold line DC
-		m_comfort.m_tooCold_m = -0.04175;
-		m_comfort.m_tooHCold_b = 23.476675;
+		m_comfort.m_tooCold_m = COMFORT_TOOCOLD_M;
+		m_comfort.m_tooHCold_b = COMFORT_TOOCOLD_B;
 		//Too dry line AD
-		m_comfort.m_tooDry_m = -77.8;
-		m_comfort.m_tooDry_b = 2364;
+		m_comfort.m_tooDry_m = COMFORT_TOODRY_M;
+		m_comfort.m_tooDry_b = COMFORT_TOODRY_B;
+#if DHT11_LOOKUP
+		m_bDefaultComfort = true;
+#endif
 	};
 
 	/**
@@ -237,7 +444,14 @@ public:
 
 	//Get and set the current comfort profile
 	ComfortProfile getComfortProfile() {return m_comfort;}
-	void setComfortProfile(ComfortProfile& c) {m_comfort = c;}
+	void setComfortProfile(ComfortProfile& c)
+	{
+		m_comfort = c;
+#if DHT11_LOOKUP
+		//The DHT11 table only knows the default profile
+		m_bDefaultComfort = false;
+#endif
+	}
 
 	/* Interrogate the current comfort profile for cold,hot,humid,dry states
 	*  If default LAST_VALUE value is used, will take into account the last read values.
@@ -255,7 +469,7 @@ public:
 		{return m_comfort.isTooDry(temp, humidity);}
 
 	/**
-	 * Get the calculated HEAT INDEX
+	 * Get the calculated HEAT INDEX, NWS algorithm
 	 * @param tempCelsius - temp in *C. Default uses the last temp reading.
 	 * 						If the reading is old, a read() is triggered
 	 * 						This can be disabled with the NO_AUTOREFRESH switch
@@ -264,9 +478,30 @@ public:
 	 * 						This can be disabled with the NO_AUTOREFRESH switch
 	 * @param bFarenheit - true if a conversion to Farenheit is desired
 	 */
-	float getHeatIndex(float tempCelsius = LAST_VALUE, float percentHumidity = LAST_VALUE
+	inline float getHeatIndex(float tempCelsius = LAST_VALUE,
+							  float percentHumidity = LAST_VALUE
+#if DHT_TEMPERATURE == 	DHT_RUNTIME
+							, bool bFarenheit = false
+#endif
+	)
+	{
+		return getHeatIndexAlg(HEAT_NWS, tempCelsius, percentHumidity
+#if DHT_TEMPERATURE == 	DHT_RUNTIME
+							   , bFarenheit
+#endif
+							   );
+	}
+
+	/**
+	 * Get the calculated HEAT INDEX with a selectable algorithm
+	 * @param algType - HEAT_NWS, HEAT_STEADMAN or HEAT_TABLE. See DHT.cpp for details
+	 * @param tempCelsius, percentHumidity, bFarenheit - see getHeatIndex()
+	 */
+	float getHeatIndexAlg(uint8_t algType,
+						  float tempCelsius = LAST_VALUE,
+						  float percentHumidity = LAST_VALUE
 #if DHT_TEMPERATURE == 	DHT_RUNTIME
-					, bool bFarenheit = false
+						, bool bFarenheit = false
 #endif
 	);
 
@@ -280,7 +515,7 @@ public:
 	 * 						This can be disabled with the NO_AUTOREFRESH switch
 	 * @param algType - Algorithm type to use. See DHT.c for details
 	 */
-	double getDewPoint(uint8_t algType = DEW_ACCURATE_FAST,
+	DHTScalar getDewPoint(uint8_t algType = DEW_ACCURATE_FAST,
 						float tempCelsius = LAST_VALUE,
 						float percentHumidity = LAST_VALUE
 #if DHT_TEMPERATURE == 	DHT_RUNTIME
@@ -303,6 +538,132 @@ public:
 						 float temp = LAST_VALUE,
 						 float percentHumidity = LAST_VALUE);
 
+#if DHT_ESTIMATOR
+	/**
+	 * Estimate temperature and humidity at any time from the trend of past
+	 * reads. Lets the sensor be read rarely (large minIntervalRead) while
+	 * still getting smooth, current values. Does not trigger a read.
+	 * Times before the last read are extrapolated backwards on the trend.
+	 * @param destReading - will hold the estimated temp(*C) and humidity
+	 * @param timeMs - millis() time of the estimate
+	 * @param destUncertainty - optional, 1 sigma of each estimate
+	 * @return - false if there was no successful read yet
+	 * */
+	bool estimateTempAndHumidity(TempAndHumidity& destReading,
+								 unsigned long timeMs,
+								 TempAndHumidity* destUncertainty = NULL);
+
+	/**
+	 * Read the sensor if the interval elapsed, then estimate for millis().
+	 * See estimateTempAndHumidity()
+	 * */
+	bool readEstimatedTempAndHumidity(TempAndHumidity& destReading,
+									  TempAndHumidity* destUncertainty = NULL);
+#endif
+
+	/**
+	 * Render the last reading and the selected derived values as one line of
+	 * text (CSV, JSON or InfluxDB line protocol) ending with '\n', ready to be
+	 * sent with a single write. Uses fixed decimals formatted from integers:
+	 * 1 decimal for temperature and humidity, 2 for derived values.
+	 * Heat index uses HEAT_NWS, all values are in *C. Values that can not be
+	 * computed (no valid reading) are empty in CSV, null in JSON and left out
+	 * in line protocol.
+	 * If the reading is old, a read() is triggered
+	 * This can be disabled with the NO_AUTOREFRESH switch
+	 * @param dest - caller buffer, always NUL terminated.
+	 * @param destSize - size of dest, TELEMETRY_MAX_LEN fits any output
+	 * @param format - TELEMETRY_CSV, TELEMETRY_JSON or TELEMETRY_INFLUX
+	 * @param fields - TELEMETRY_* field flags
+	 * @param dewAlgType - dew point algorithm, see getDewPoint()
+	 * @return - length of the line, 0 if the read failed or dest is too small
+	 */
+	uint16_t getTelemetry(char* dest, uint16_t destSize,
+						  uint8_t format = TELEMETRY_CSV,
+						  uint8_t fields = TELEMETRY_ALL,
+						  uint8_t dewAlgType = DEW_ACCURATE_FAST);
+
+	/**
+	 * Name of a comfort state, ex "Comfort_TooHot"
+	 */
+	static const char* getComfortStateName(ComfortState state);
+
+	/**
+	 * Adaptive reads: a reading that changed less than the deltas from the
+	 * previous one doubles the time between reads, up to maxIntervalMs.
+	 * A bigger change, a comfort state change (alert), a read error or
+	 * resetReadInterval() go back to the minimum interval at once.
+	 * Saves bus time, interrupt-off windows, power and self-heating.
+	 * @param maxIntervalMs - ceiling for the interval, 0 disables it. Never
+	 * 						  reads faster than the minimum interval
+	 * @param tempDelta - change in *C still considered stable
+	 * @param humidDelta - change in % still considered stable
+	 * */
+	void setAdaptiveInterval(uint16_t maxIntervalMs,
+							 float tempDelta = 0.2f,
+							 float humidDelta = 1.0f);
+
+	/**
+	 * Go back to the minimum interval, ex on an application defined alert
+	 * */
+	void resetReadInterval();
+
+	//Current minimum time between reads in ms
+	inline uint16_t getReadInterval() { return m_minIntervalRead; }
+	inline const ReadIntervalStats& getReadIntervalStats() { return m_intervalStats; }
+
+	/**
+	 * Capture scheduling: a due read waits, answering from the cache, until
+	 * its interrupt-off capture fits in an announced quiet window and the
+	 * veto allows it. The LOW wakeup pulse is stretched (up to
+	 * CAPTURE_MAX_WAKEUP_STRETCH_MS) so the capture starts with the window.
+	 * With no window announced, only the veto is asked. After maxDeferMs
+	 * the capture is done anyway. Accessors must be called often enough
+	 * (ex every loop) to catch the windows. Call after begin().
+	 * Clears the announced windows.
+	 * @param maxDeferMs - deadline after the read is due, 0 disables scheduling
+	 * @param veto - may be NULL
+	 * */
+	void setCaptureScheduling(uint16_t maxDeferMs, CaptureVetoCallback veto = NULL);
+
+	/**
+	 * Advertise the next time without WiFi, timer or other interrupt activity.
+	 * Replaces any window announced before.
+	 * @param startMs - millis() time the window starts, may be in the past
+	 * @param lengthMs - window length, at least CAPTURE_DURATION_MS to be used
+	 * */
+	void announceQuietWindow(unsigned long startMs, uint16_t lengthMs);
+
+	/**
+	 * Stop waiting for announced windows, ex when the host stops announcing
+	 * them. Only the veto is asked again.
+	 * */
+	inline void clearQuietWindows() { m_bWindowsAnnounced = false; }
+
+	inline const CaptureStats& getCaptureStats() { return m_captureStats; }
+
+	/**
+	 * Every read attempt, failed ones included, will be pushed in this queue
+	 * from the context calling read(). See DHTReadingQueue.h
+	 * @param pQueue - the queue, NULL to stop
+	 * */
+	void setReadingQueue(DHTReadingQueue* pQueue) {m_pQueue = pQueue;}
+
+	/**
+	 * Every read attempt will be published in this snapshot, where any number
+	 * of tasks or threads can read it consistently without locks. Only the
+	 * context calling read() writes it. See DHTReadingSnapshot.h
+	 * @param pSnapshot - the snapshot, NULL to stop
+	 * */
+	void setReadingSnapshot(DHTReadingSnapshot* pSnapshot) {m_pSnapshot = pSnapshot;}
+
+	/**
+	 * Every successful read adds temp, humidity and dew point (DEW_ACCURATE_FAST)
+	 * to these rollups. See DHTRollup.h
+	 * @param pRollup - the rollups, NULL to stop
+	 * */
+	void setRollup(DHTRollup* pRollup) {m_pRollup = pRollup;}
+
 	/**
 	 * Gets the last occurred error.
 	 */
@@ -311,6 +672,12 @@ public:
 private:
 	bool read();
 	void updateInternalCache();
+	void publishReading();
+	void adaptInterval();
+	bool scheduleCapture(unsigned long time, uint8_t& destStretchMs);
+#if DHT11_LOOKUP
+	bool lookupDHT11(float temp, float humid, uint32_t& destEntry);
+#endif
 	
 	uint8_t m_kSensorPin, m_kSensorType;
 	uint8_t m_data[6];
@@ -318,6 +685,9 @@ private:
 	uint8_t m_wakeupTimeMs;
 
 	ComfortProfile m_comfort;
+#if DHT11_LOOKUP
+	bool m_bDefaultComfort;
+#endif
 
 	ErrorDHT m_lastError;
 
@@ -327,7 +697,38 @@ private:
 	//Reference: http://www.kandrsmith.org/RJS/Misc/dht_sht_how_fast.html
 	uint16_t m_minIntervalRead;
 
+	//adaptive interval: minimum, ceiling (0 = off) and stability deltas
+	uint16_t m_baseIntervalRead, m_adaptiveMaxInterval;
+	float m_adaptTempDelta, m_adaptHumidDelta;
+	float m_adaptPrevTemp, m_adaptPrevHumid;
+	ComfortState m_adaptPrevComfort;
+	ReadIntervalStats m_intervalStats;
+
+	//capture scheduling: deadline (0 = off), veto, announced window, pending
+	//due read
+	uint16_t m_maxDeferMs;
+	CaptureVetoCallback m_captureVeto;
+	unsigned long m_quietStart;
+	uint16_t m_quietLength;
+	bool m_bWindowsAnnounced;
+	bool m_bCaptureDue;
+	unsigned long m_captureDueTime;
+	CaptureStats m_captureStats;
+
 	//internal cache, last read values
 	float m_lastTemp, m_lastHumid;
+
+	uint16_t m_readSeq;
+	DHTReadingQueue* m_pQueue;
+	DHTReadingSnapshot* m_pSnapshot;
+	DHTRollup* m_pRollup;
+
+#if DHT_ESTIMATOR
+	void updateEstimator();
+
+	TrendFilter m_tempFilter, m_humidFilter;
+	unsigned long m_filterTime;
+	bool m_bFilterValid;
+#endif
 };
 #endif
@@ -0,0 +1,174 @@
+/*
+ * Name: libDHT
+ * License: MIT license. See details in DHT.cpp.
+ * Location: https://github.com/ADiea/libDHT
+ * Maintainer: ADiea (https://github.com/ADiea)
+ *
+ * Descr: Derived values for every reading a DHT11 can return, generated at
+ *        compile time and stored in flash. A DHT11 reports integer *C
+ *        (0..50) and integer %RH (20..90): 51 x 71 = 3621 pairs.
+ *        Included by DHT.cpp when DHT11_LOOKUP is 1.
+ *
+ * Entry packing, 32 bits:
+ *   bits  0..9  dew point (DEW_ACCURATE_FAST), (*C + 32) * 10
+ *   bits 10..20 heat index (HEAT_NWS), (*C + 8) * 10
+ *   bits 21..27 comfort ratio for the default profile, integer %
+ *   bits 28..31 comfort state for the default profile
+ */
+#ifndef DHT11_TABLE_H
+#define DHT11_TABLE_H
+
+#include "DHT.h"
+
+#define DHT11_TABLE_T_MIN 0
+#define DHT11_TABLE_T_MAX 50
+#define DHT11_TABLE_RH_MIN 20
+#define DHT11_TABLE_RH_MAX 90
+#define DHT11_TABLE_RH_COUNT (DHT11_TABLE_RH_MAX - DHT11_TABLE_RH_MIN + 1)
+
+#define DHT11_TABLE_DEW_OFFSET 32
+#define DHT11_TABLE_HEAT_OFFSET 8
+
+/*********************** COMPILE TIME MATH ***********************/
+/* C++11 constexpr: single return statements and recursion only */
+
+#define DHT11_CX_LN2 0.69314718055994530942
+
+//atanh series term by term, ln(x) = 2 * atanh((x - 1) / (x + 1))
+constexpr double dht11CxAtanh(double y, double y2, double power, int n)
+{
+	return (n > 41) ? 0 : power / n + dht11CxAtanh(y, y2, power * y2, n + 2);
+}
+
+//Natural log, reduced to [0.75, 1.5] by powers of 2 so the series converges fast
+constexpr double dht11CxLog(double x)
+{
+	return (x > 1.5) ? DHT11_CX_LN2 + dht11CxLog(x * 0.5) :
+		   (x < 0.75) ? -DHT11_CX_LN2 + dht11CxLog(x * 2) :
+		   2 * dht11CxAtanh((x - 1) / (x + 1), ((x - 1) / (x + 1)) * ((x - 1) / (x + 1)),
+							(x - 1) / (x + 1), 1);
+}
+
+//Same as DHT::computeDewPoint(DEW_ACCURATE_FAST)
+constexpr double dht11CxDewFromLog(double l)
+{
+	return (241.88 * l) / (17.558 - l);
+}
+
+constexpr double dht11CxDewPoint(double t, double rh)
+{
+	return dht11CxDewFromLog(dht11CxLog(rh * 0.01 *
+			(6.107799961 +
+			 t * (0.4436518521 +
+			 t * (0.01428945805 +
+			 t * (2.650648471e-4 +
+			 t * (3.031240396e-6 +
+			 t * (2.034080948e-8 +
+			 t * 6.136820929e-11)))))) / (10 * 0.61078)));
+}
+
+//Same as DHT::computeHeatIndex(HEAT_NWS), in *F. RH >= 20 here, so the low
+//humidity adjustment never applies
+constexpr double dht11CxRothfusz(double t, double rh)
+{
+	return -42.379 + rh * (10.14333127 + rh * -0.05481717) +
+		   t * (2.04901523 + rh * (-0.22475541 + rh * 0.00085282) +
+		   t * (-0.00683783 + rh * (0.00122874 + rh * -0.00000199))) +
+		   (((rh > 85) && (t >= 80) && (t <= 87)) ? ((rh - 85) * 0.1) * ((87 - t) * 0.2) : 0);
+}
+
+constexpr double dht11CxHeatIndexF(double t, double rh, double steadman)
+{
+	return ((steadman + t) * 0.5 >= 80) ? dht11CxRothfusz(t, rh) : steadman;
+}
+
+constexpr double dht11CxHeatIndex(double c, double rh)
+{
+	return (dht11CxHeatIndexF(c * 1.8 + 32, rh,
+			0.5 * ((c * 1.8 + 32) + 61.0 + (((c * 1.8 + 32) - 68.0) * 1.2) + (rh * 0.094)))
+			- 32) / 1.8;
+}
+
+//Same as DHT::computeComfortRatio<float>() with the default profile,
+//in float so the classification matches the runtime one
+constexpr float dht11CxPositive(float x)
+{
+	return (x > 0) ? x : 0;
+}
+
+constexpr float dht11CxComfortRatio(float t, float rh)
+{
+	return dht11CxPositive(100.0f
+		- dht11CxPositive(t - (rh * COMFORT_TOOHOT_M + COMFORT_TOOHOT_B)) * 3.0f
+		- dht11CxPositive(t - (rh * COMFORT_TOOHUMID_M + COMFORT_TOOHUMID_B)) * 0.1f
+		- dht11CxPositive((rh * COMFORT_TOOCOLD_M + COMFORT_TOOCOLD_B) - t) * 3.0f
+		- dht11CxPositive((rh * COMFORT_TOODRY_M + COMFORT_TOODRY_B) - t) * 0.1f);
+}
+
+constexpr uint32_t dht11CxComfortState(float t, float rh)
+{
+	return ((t - (rh * COMFORT_TOOHOT_M + COMFORT_TOOHOT_B) > 0) ? Comfort_TooHot : 0) +
+		   ((t - (rh * COMFORT_TOOHUMID_M + COMFORT_TOOHUMID_B) > 0) ? Comfort_TooHumid : 0) +
+		   (((rh * COMFORT_TOOCOLD_M + COMFORT_TOOCOLD_B) - t > 0) ? Comfort_TooCold : 0) +
+		   (((rh * COMFORT_TOODRY_M + COMFORT_TOODRY_B) - t > 0) ? Comfort_TooDry : 0);
+}
+
+constexpr uint32_t dht11CxRound(double x)
+{
+	return (uint32_t)(x + 0.5);
+}
+
+constexpr uint32_t dht11CxEntry(int t, int rh)
+{
+	return dht11CxRound((dht11CxDewPoint(t, rh) + DHT11_TABLE_DEW_OFFSET) * 10) |
+		   (dht11CxRound((dht11CxHeatIndex(t, rh) + DHT11_TABLE_HEAT_OFFSET) * 10) << 10) |
+		   (dht11CxRound(dht11CxComfortRatio(t, rh)) << 21) |
+		   (dht11CxComfortState(t, rh) << 28);
+}
+
+/*********************** THE TABLE ***********************/
+
+#define DHT11_E(t, rh) dht11CxEntry(t, rh)
+#define DHT11_E10(t, rh) \
+	DHT11_E(t, rh), DHT11_E(t, rh + 1), DHT11_E(t, rh + 2), DHT11_E(t, rh + 3), \
+	DHT11_E(t, rh + 4), DHT11_E(t, rh + 5), DHT11_E(t, rh + 6), DHT11_E(t, rh + 7), \
+	DHT11_E(t, rh + 8), DHT11_E(t, rh + 9)
+//One temperature, RH 20..90
+#define DHT11_ROW(t) \
+	DHT11_E10(t, 20), DHT11_E10(t, 30), DHT11_E10(t, 40), DHT11_E10(t, 50), \
+	DHT11_E10(t, 60), DHT11_E10(t, 70), DHT11_E10(t, 80), DHT11_E(t, 90)
+#define DHT11_ROW10(t) \
+	DHT11_ROW(t), DHT11_ROW(t + 1), DHT11_ROW(t + 2), DHT11_ROW(t + 3), \
+	DHT11_ROW(t + 4), DHT11_ROW(t + 5), DHT11_ROW(t + 6), DHT11_ROW(t + 7), \
+	DHT11_ROW(t + 8), DHT11_ROW(t + 9)
+
+//constexpr: fails to compile rather than silently moving to RAM
+static constexpr uint32_t s_dht11Table[] PROGMEM =
+{
+	DHT11_ROW10(0), DHT11_ROW10(10), DHT11_ROW10(20), DHT11_ROW10(30),
+	DHT11_ROW10(40), DHT11_ROW(50)
+};
+
+/*********************** DECODING ***********************/
+
+static inline float dht11TableDewPoint(uint32_t entry)
+{
+	return (entry & 0x3FF) * 0.1f - DHT11_TABLE_DEW_OFFSET;
+}
+
+static inline float dht11TableHeatIndex(uint32_t entry)
+{
+	return ((entry >> 10) & 0x7FF) * 0.1f - DHT11_TABLE_HEAT_OFFSET;
+}
+
+static inline float dht11TableComfortRatio(uint32_t entry)
+{
+	return (entry >> 21) & 0x7F;
+}
+
+static inline ComfortState dht11TableComfortState(uint32_t entry)
+{
+	return (ComfortState)(entry >> 28);
+}
+
+#endif
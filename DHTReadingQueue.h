@@ -0,0 +1,144 @@
+/*
+ * Name: libDHT
+ * License: MIT license. See details in DHT.cpp.
+ * Location: https://github.com/ADiea/libDHT
+ * Maintainer: ADiea (https://github.com/ADiea)
+ *
+ * Descr: Fixed capacity, wait-free single producer / single consumer queue
+ *        of DHTReading records. Lets every read be handed from the reading
+ *        context (ISR, RTOS task, thread) to a consumer without locks.
+ *
+ * Usage:
+ *   DHTReading storage[8];
+ *   DHTReadingQueue queue(storage, 8);
+ *   dht.setReadingQueue(&queue);      //producer: every read() pushes
+ *   while(queue.pop(reading)) {...}   //consumer
+ */
+#ifndef DHT_READING_QUEUE_H
+#define DHT_READING_QUEUE_H
+
+#include "DHT.h"
+
+/* Free running positions. A full queue must still show as head - tail ==
+ * capacity, so capacity is limited to half the index range on 8 bit AVR */
+typedef DHTAtomicWord DHTQueueIndex;
+#if defined(__AVR__)
+#define QUEUE_MAX_CAPACITY 128
+#else
+#define QUEUE_MAX_CAPACITY 32768
+#endif
+
+/* Producer and consumer fields on separate cache lines, so that one side
+ * writing does not evict the other's line. Not on single core MCUs, where
+ * it only costs RAM */
+#if defined(__AVR__) || defined(ESP8266)
+#define QUEUE_CACHE_ALIGN
+#else
+#define QUEUE_CACHE_ALIGN alignas(64)
+#endif
+
+class DHTReadingQueue
+{
+public:
+	/**
+	 * Constructor.
+	 * @param storage - caller owned array of capacity records
+	 * @param capacity - number of records, at least 1. Rounded down to a
+	 * 					 power of 2 and to QUEUE_MAX_CAPACITY, see getCapacity()
+	 * */
+	DHTReadingQueue(DHTReading* storage, uint16_t capacity)
+		: m_storage(storage), m_mask(usableCapacity(capacity) - 1),
+		  m_head(0), m_tailCache(0), m_overflows(0),
+		  m_tail(0), m_headCache(0)
+	{
+	}
+
+	/**
+	 * Producer side. Copies the record in the queue.
+	 * @return - false if the queue is full, the record is dropped and counted
+	 * */
+	inline bool push(const DHTReading& reading)
+	{
+		DHTQueueIndex head = m_head;
+
+		//Only look at the consumer's position when the cached one says full
+		if ((DHTQueueIndex)(head - m_tailCache) > m_mask)
+		{
+			m_tailCache = __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE);
+			if ((DHTQueueIndex)(head - m_tailCache) > m_mask)
+			{
+				m_overflows = m_overflows + 1;
+				return false;
+			}
+		}
+
+		m_storage[head & m_mask] = reading;
+		//Publish the record after it was written
+		__atomic_store_n(&m_head, (DHTQueueIndex)(head + 1), __ATOMIC_RELEASE);
+		return true;
+	}
+
+	/**
+	 * Consumer side.
+	 * @param dest - receives the oldest record
+	 * @return - false if the queue is empty
+	 * */
+	inline bool pop(DHTReading& dest)
+	{
+		DHTQueueIndex tail = m_tail;
+
+		if (tail == m_headCache)
+		{
+			m_headCache = __atomic_load_n(&m_head, __ATOMIC_ACQUIRE);
+			if (tail == m_headCache)
+				return false;
+		}
+
+		dest = m_storage[tail & m_mask];
+		//Give the slot back after it was read
+		__atomic_store_n(&m_tail, (DHTQueueIndex)(tail + 1), __ATOMIC_RELEASE);
+		return true;
+	}
+
+	/**
+	 * Number of queued records. Exact only from the producer or consumer.
+	 * */
+	inline uint16_t size() const
+	{
+		return (DHTQueueIndex)(__atomic_load_n(&m_head, __ATOMIC_ACQUIRE) -
+							   __atomic_load_n(&m_tail, __ATOMIC_ACQUIRE));
+	}
+
+	inline uint16_t getCapacity() const { return m_mask + 1; }
+
+	/**
+	 * Records dropped because the queue was full. Statistics only, may be
+	 * torn on 8 bit targets while the producer is running.
+	 * */
+	inline uint32_t getOverflowCount() const { return m_overflows; }
+
+private:
+	static inline uint16_t usableCapacity(uint16_t capacity)
+	{
+		uint16_t usable = 1;
+
+		while ((usable <= capacity / 2) && (usable < QUEUE_MAX_CAPACITY))
+			usable <<= 1;
+		return usable;
+	}
+
+	//Read only after construction
+	DHTReading* m_storage;
+	uint16_t m_mask;
+
+	//Written by the producer only
+	QUEUE_CACHE_ALIGN DHTQueueIndex m_head;
+	DHTQueueIndex m_tailCache;
+	volatile uint32_t m_overflows;
+
+	//Written by the consumer only
+	QUEUE_CACHE_ALIGN DHTQueueIndex m_tail;
+	DHTQueueIndex m_headCache;
+};
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * Name: libDHT
+ * License: MIT license. See details in DHT.cpp.
+ * Location: https://github.com/ADiea/libDHT
+ * Maintainer: ADiea (https://github.com/ADiea)
+ *
+ * Descr: Single writer, many readers snapshot of the last DHTReading
+ *        (sequence lock). The writer never waits; readers retry if a write
+ *        happened while they were copying, so they never see a temperature
+ *        from one frame and a humidity from another.
+ *
+ * Usage:
+ *   DHTReadingSnapshot snapshot;
+ *   dht.setReadingSnapshot(&snapshot);  //task calling dht: publishes
+ *   snapshot.read(reading);             //any other task or thread
+ *
+ * Note: on a single core RTOS, a reader with higher priority than the writer
+ *       spins while the writer is preempted mid-publish. Use tryRead() there.
+ */
+#ifndef DHT_READING_SNAPSHOT_H
+#define DHT_READING_SNAPSHOT_H
+
+#include "DHT.h"
+
+//The reading is copied word by word, each word is one atomic access
+#define SNAPSHOT_WORDS ((sizeof(DHTReading) + sizeof(DHTAtomicWord) - 1) / sizeof(DHTAtomicWord))
+
+class DHTReadingSnapshot
+{
+public:
+	DHTReadingSnapshot() : m_seq(0)
+	{
+	}
+
+	/**
+	 * Writer side, one context only.
+	 * */
+	inline void publish(const DHTReading& reading)
+	{
+		DHTAtomicWord words[SNAPSHOT_WORDS];
+		DHTAtomicWord seq = m_seq;
+
+		memcpy(words, &reading, sizeof(reading));
+
+		//Odd: write in progress. The fence keeps the data after it
+		__atomic_store_n(&m_seq, (DHTAtomicWord)(seq + 1), __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+
+		for (uint8_t i = 0; i < SNAPSHOT_WORDS; i++)
+			__atomic_store_n(&m_words[i], words[i], __ATOMIC_RELAXED);
+
+		//Even again, releases the data. 0 is kept for "never published"
+		seq += 2;
+		if (0 == seq)
+			seq = 2;
+		__atomic_store_n(&m_seq, seq, __ATOMIC_RELEASE);
+	}
+
+	/**
+	 * Reader side, any number of contexts. Single attempt.
+	 * @param dest - receives the last published reading
+	 * @return - false if a write was in progress or nothing was published yet
+	 * */
+	inline bool tryRead(DHTReading& dest) const
+	{
+		DHTAtomicWord words[SNAPSHOT_WORDS];
+		DHTAtomicWord seq = __atomic_load_n(&m_seq, __ATOMIC_ACQUIRE);
+
+		if ((seq & 1) || (0 == seq))
+			return false;
+
+		for (uint8_t i = 0; i < SNAPSHOT_WORDS; i++)
+			words[i] = __atomic_load_n(&m_words[i], __ATOMIC_RELAXED);
+
+		//The data loads must complete before checking the sequence again
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (seq != __atomic_load_n(&m_seq, __ATOMIC_RELAXED))
+			return false;
+
+		memcpy(&dest, words, sizeof(dest));
+		return true;
+	}
+
+	/**
+	 * Reader side, retries until the copy is consistent.
+	 * @param dest - receives the last published reading
+	 * @return - false if nothing was published yet
+	 * */
+	inline bool read(DHTReading& dest) const
+	{
+		while (!tryRead(dest))
+		{
+			if (0 == __atomic_load_n(&m_seq, __ATOMIC_ACQUIRE))
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 * Number of publishes so far, wraps. Lets readers skip unchanged data.
+	 * */
+	inline DHTAtomicWord getVersion() const
+	{
+		return __atomic_load_n(&m_seq, __ATOMIC_ACQUIRE) >> 1;
+	}
+
+private:
+	DHTAtomicWord m_seq;
+	DHTAtomicWord m_words[SNAPSHOT_WORDS];
+};
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * Name: libDHT
+ * License: MIT license. See details in DHT.cpp.
+ * Location: https://github.com/ADiea/libDHT
+ * Maintainer: ADiea (https://github.com/ADiea)
+ *
+ * Descr: Incremental time-series rollups. See DHTRollup.h
+ */
+
+#include "DHTRollup.h"
+
+static inline void mergeStat(RollupStat& dest, const RollupStat& src)
+{
+	if (0 == src.count)
+		return;
+
+	if (0 == dest.count)
+	{
+		dest = src;
+		return;
+	}
+
+	dest.count += src.count;
+	dest.sum += src.sum;
+	if (src.min < dest.min)
+		dest.min = src.min;
+	if (src.max > dest.max)
+		dest.max = src.max;
+	//src is always the newer one
+	dest.last = src.last;
+}
+
+static inline void initStat(RollupStat& dest, float value)
+{
+	if (isnan(value))
+	{
+		//would poison sum, min and max of every tier above
+		dest.count = 0;
+		dest.sum = 0;
+	}
+	else
+	{
+		dest.count = 1;
+		dest.sum = value;
+	}
+	dest.min = dest.max = dest.last = value;
+}
+
+DHTRollup::DHTRollup(RollupTier* tiers, uint8_t tierCount,
+					 RollupCallback callback/* = NULL*/)
+	: m_pTiers(tiers), m_tierCount(tierCount), m_callback(callback)
+{
+	for (uint8_t i = 0; i < m_tierCount; i++)
+	{
+		m_pTiers[i].bucket.count = 0;
+	}
+}
+
+void DHTRollup::add(unsigned long timeMs, float temp, float humid, float dew)
+{
+	RollupBucket sample;
+
+	//Complete the buckets this sample is past. Completing a tier folds it
+	//into the next one, which is then checked in turn
+	for (uint8_t i = 0; i < m_tierCount; i++)
+	{
+		RollupTier& tier = m_pTiers[i];
+
+		if (tier.bucket.count && (timeMs - tier.bucket.startMs >= tier.periodMs))
+			complete(i);
+	}
+
+	sample.startMs = timeMs;
+	sample.count = 1;
+	initStat(sample.temp, temp);
+	initStat(sample.humid, humid);
+	initStat(sample.dew, dew);
+
+	fold(0, sample);
+}
+
+void DHTRollup::flush()
+{
+	//Lower tiers first, so their data reaches the upper ones
+	for (uint8_t i = 0; i < m_tierCount; i++)
+	{
+		if (m_pTiers[i].bucket.count)
+			complete(i);
+	}
+}
+
+void DHTRollup::fold(uint8_t i, const RollupBucket& bucket)
+{
+	RollupTier& tier = m_pTiers[i];
+
+	if (tier.bucket.count && (bucket.startMs - tier.bucket.startMs >= tier.periodMs))
+		complete(i);
+
+	if (0 == tier.bucket.count)
+	{
+		tier.bucket = bucket;
+		tier.bucket.startMs = bucket.startMs - bucket.startMs % tier.periodMs;
+	}
+	else
+	{
+		tier.bucket.count += bucket.count;
+		mergeStat(tier.bucket.temp, bucket.temp);
+		mergeStat(tier.bucket.humid, bucket.humid);
+		mergeStat(tier.bucket.dew, bucket.dew);
+	}
+}
+
+void DHTRollup::complete(uint8_t i)
+{
+	RollupBucket& bucket = m_pTiers[i].bucket;
+
+	if (m_callback)
+		m_callback(i, bucket);
+
+	if (i + 1 < m_tierCount)
+		fold(i + 1, bucket);
+
+	bucket.count = 0;
+}
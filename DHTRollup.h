@@ -0,0 +1,92 @@
+/*
+ * Name: libDHT
+ * License: MIT license. See details in DHT.cpp.
+ * Location: https://github.com/ADiea/libDHT
+ * Maintainer: ADiea (https://github.com/ADiea)
+ *
+ * Descr: Incremental time-series rollups (ex per minute, per hour) of
+ *        temperature, humidity and dew point in fixed memory.
+ *        Each tier keeps one open bucket with count, sum, min, max, last.
+ *        A sample only touches tier 0; a completed bucket is handed to the
+ *        callback and folded into the next tier. Memory depends on the number
+ *        of tiers only, cost per sample is O(tiers) at worst.
+ *
+ * Usage:
+ *   RollupTier tiers[] = {{60000UL}, {3600000UL}};   //minute, hour
+ *   DHTRollup rollup(tiers, 2, onBucket);
+ *   dht.setRollup(&rollup);      //every successful read() adds a sample
+ *
+ * Note: buckets are aligned to multiples of their period in millis() time,
+ *       the bucket spanning a millis() wrap (49 days) is cut short.
+ */
+#ifndef DHT_ROLLUP_H
+#define DHT_ROLLUP_H
+
+#include "DHT.h"
+
+/* NAN samples (ex dew point at 0%RH) are left out of the stat, they are
+ * only in the bucket count */
+struct RollupStat
+{
+	uint32_t count; //valid samples, min, max and last are NAN if 0
+	float sum, min, max, last;
+
+	inline float getMean() const {return count ? sum / count : NAN;}
+};
+
+struct RollupBucket
+{
+	unsigned long startMs; //start of the bucket, multiple of the tier period
+	uint32_t count; //samples, 0 if the bucket is empty
+	RollupStat temp, humid, dew;
+};
+
+/* periodMs must be a multiple of the previous tier's period */
+struct RollupTier
+{
+	unsigned long periodMs;
+	RollupBucket bucket; //open bucket
+};
+
+/**
+ * Called for every completed bucket
+ * @param tier - index of the tier, 0 is the shortest period
+ * @param bucket - the completed bucket
+ */
+typedef void (*RollupCallback)(uint8_t tier, const RollupBucket& bucket);
+
+class DHTRollup
+{
+public:
+	/**
+	 * Constructor.
+	 * @param tiers - caller owned tiers with periodMs set, shortest first
+	 * @param tierCount - number of tiers
+	 * @param callback - receives completed buckets, may be NULL
+	 * */
+	DHTRollup(RollupTier* tiers, uint8_t tierCount, RollupCallback callback = NULL);
+
+	/**
+	 * Add one sample
+	 * @param timeMs - millis() time of the sample, not decreasing
+	 * */
+	void add(unsigned long timeMs, float temp, float humid, float dew);
+
+	/**
+	 * Complete all open buckets now, ex before going to deep sleep
+	 * */
+	void flush();
+
+	//The open bucket of a tier, count is 0 if it has no samples yet
+	inline const RollupBucket& getOpenBucket(uint8_t tier) const {return m_pTiers[tier].bucket;}
+
+private:
+	void fold(uint8_t tier, const RollupBucket& bucket);
+	void complete(uint8_t tier);
+
+	RollupTier* m_pTiers;
+	uint8_t m_tierCount;
+	RollupCallback m_callback;
+};
+
+#endif
@@ -19,7 +19,7 @@ DHT dht(DHTPIN);
 
 TempAndHumidity th;
 
-ComfortState cf;
+char line[TELEMETRY_MAX_LEN];
 
 void setup() {
   Serial.begin(9600);
@@ -55,61 +55,9 @@ void loop()
 	return;
   }
 
-  // Compute heat index in Celsius (the default)
-  float hic = dht.getHeatIndex();
-  
-  // Compute dew point in Celsius (the default) using the ACCURATE algorithm
-  double dp = dht.getDewPoint(DEW_ACCURATE);
-  
-  //Compute comfort ratio in percents
-  float cr = dht.getComfortRatio(cf);
-
-  //Print line comma separrated values
-  Serial.print(th.humid);
-  Serial.print(",");
-  Serial.print(th.temp);
-  Serial.print(",");
-  Serial.print(hic);
-  Serial.print(",");
-  Serial.print(dp);
-  Serial.print(",");
-  Serial.print(cr); 
-  Serial.print(",");
-
-  switch(cf)
-  {
-  case Comfort_OK:
-	Serial.print("Comfort_OK");
-	break;
-  case Comfort_TooHot:
-	Serial.print("Comfort_TooHot");
-	break;
-  case Comfort_TooCold:
-	Serial.print("Comfort_TooCold");
-	break;
-  case Comfort_TooDry:
-	Serial.print("Comfort_TooDry");
-	break;
-  case Comfort_TooHumid:
-	Serial.print("Comfort_TooHumid");
-	break;
-  case Comfort_HotAndHumid:
-	Serial.print("Comfort_HotAndHumid");
-	break;
-  case Comfort_HotAndDry:
-	Serial.print("Comfort_HotAndDry");
-	break;
-  case Comfort_ColdAndHumid:
-	Serial.print("Comfort_ColdAndHumid");
-	break;
-  case Comfort_ColdAndDry:
-	Serial.print("Comfort_ColdAndDry");
-	break;
-  default:
-	Serial.print("Unknown:");
-	Serial.print((int)cf);
-	break;
-  };
- 
-  Serial.print("\n");
+  // Render humidity, temperature, heat index, dew point (ACCURATE algorithm)
+  // and comfort as one CSV line in *C, and send it with a single call
+  uint16_t len = dht.getTelemetry(line, sizeof(line), TELEMETRY_CSV,
+                                  TELEMETRY_ALL, DEW_ACCURATE);
+  Serial.write((const uint8_t*)line, len);
 }
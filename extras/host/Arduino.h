@@ -0,0 +1,70 @@
+/*
+ * Name: libDHT
+ * License: MIT license. See details in DHT.cpp.
+ * Location: https://github.com/ADiea/libDHT
+ * Maintainer: ADiea (https://github.com/ADiea)
+ *
+ * Descr: Minimal Arduino API for building the library on a PC, for the tests
+ *        and benchmarks in this folder. Time is virtual: millis() only moves
+ *        with delay() or when a test advances g_hostMillis.
+ *        The sensor is simulated bit by bit from g_hostFrame.
+ */
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define DEC 10
+#define HEX 16
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+
+//virtual clock in ms, microseconds since the sensor pin was released
+extern unsigned long g_hostMillis;
+extern long g_hostUs;
+//frame the simulated sensor sends, false: sensor does not answer
+extern uint8_t g_hostFrame[5];
+extern bool g_hostSensor;
+//called on cli(), with millis() of the capture start. May be NULL
+extern void (*g_hostOnCli)(void);
+
+inline unsigned long millis() { return g_hostMillis; }
+inline void delay(unsigned long ms) { g_hostMillis += ms; }
+inline void delayMicroseconds(unsigned int us) { g_hostUs += us; }
+inline void pinMode(uint8_t, uint8_t mode) { if (INPUT_PULLUP == mode) g_hostUs = 0; }
+inline void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t);
+inline void cli() { if (g_hostOnCli) g_hostOnCli(); }
+inline void sei() {}
+
+struct HostSerial
+{
+	template<class T> void print(T) {}
+	template<class T> void print(T, int) {}
+	template<class T> void println(T) {}
+	template<class T> void println(T, int) {}
+	void println() {}
+	size_t write(const char* s, size_t n) { return fwrite(s, 1, n, stdout); }
+};
+extern HostSerial Serial;
+
+/**
+ * Make the simulated sensor answer with this DHT22 reading from now on
+ * @param temp - *C, one decimal is kept
+ * @param humid - %, one decimal is kept
+ * */
+void hostSetReading(float temp, float humid);
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Name: libDHT
+ * License: MIT license. See details in DHT.cpp.
+ * Location: https://github.com/ADiea/libDHT
+ * Maintainer: ADiea (https://github.com/ADiea)
+ *
+ * Descr: Host side of Arduino.h: virtual clock and a simulated DHT22.
+ */
+#include "Arduino.h"
+
+unsigned long g_hostMillis = 0;
+long g_hostUs = 0;
+uint8_t g_hostFrame[5];
+bool g_hostSensor = true;
+void (*g_hostOnCli)(void) = NULL;
+HostSerial Serial;
+
+/* Pin level g_hostUs after release: 80us LOW + 80us HIGH response, then
+ * 50us LOW + 26us ('0') or 70us ('1') HIGH per bit, MSB first */
+int digitalRead(uint8_t)
+{
+	long t = g_hostUs;
+	uint8_t bit;
+
+	if (!g_hostSensor)
+		return HIGH;
+
+	//pullup delay before the sensor answers
+	if (t < 30)
+		return HIGH;
+	t -= 30;
+	if (t < 80)
+		return LOW;
+	t -= 80;
+	if (t < 80)
+		return HIGH;
+	t -= 80;
+
+	for (bit = 0; bit < 40; bit++)
+	{
+		long high = ((g_hostFrame[bit / 8] >> (7 - bit % 8)) & 1) ? 70 : 26;
+
+		if (t < 50)
+			return LOW;
+		t -= 50;
+		if (t < high)
+			return HIGH;
+		t -= high;
+	}
+
+	return (t < 50) ? LOW : HIGH;
+}
+
+void hostSetReading(float temp, float humid)
+{
+	uint16_t t = (uint16_t)((temp < 0 ? -temp : temp) * 10 + 0.5f);
+	uint16_t h = (uint16_t)(humid * 10 + 0.5f);
+
+	g_hostFrame[0] = h >> 8;
+	g_hostFrame[1] = h & 0xFF;
+	g_hostFrame[2] = (t >> 8) | (temp < 0 ? 0x80 : 0);
+	g_hostFrame[3] = t & 0xFF;
+	g_hostFrame[4] = g_hostFrame[0] + g_hostFrame[1] + g_hostFrame[2] + g_hostFrame[3];
+}
@@ -0,0 +1,72 @@
+/*
+ * Name: libDHT
+ * License: MIT license. See details in DHT.cpp.
+ * Location: https://github.com/ADiea/libDHT
+ * Maintainer: ADiea (https://github.com/ADiea)
+ *
+ * Descr: Checks and timing for the host tests and benchmarks.
+ *        A test returns HOST_RESULT() from main(): non zero if a check failed.
+ */
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <thread>
+#include <pthread.h>
+
+static int s_hostFailures __attribute__((unused)) = 0;
+
+#define HOST_CHECK(cond) \
+	do { if (!(cond)) { s_hostFailures++; \
+		printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); } } while (0)
+
+#define HOST_CHECK_NEAR(a, b, tol) \
+	do { double _a = (a), _b = (b); if (!(fabs(_a - _b) <= (tol))) { s_hostFailures++; \
+		printf("FAIL %s:%d: %s = %f, expected %f +- %f\n", __FILE__, __LINE__, \
+			   #a, _a, _b, (double)(tol)); } } while (0)
+
+#define HOST_RESULT() \
+	(printf("%s: %s\n", __FILE__, s_hostFailures ? "FAILED" : "OK"), s_hostFailures ? 1 : 0)
+
+//Wall clock in us, for benchmarks
+static inline double hostNowUs()
+{
+	return std::chrono::duration<double, std::micro>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//CPUs this process may run on
+static inline unsigned hostCpuCount()
+{
+	cpu_set_t set;
+
+	if (0 != sched_getaffinity(0, sizeof(set), &set))
+		return 1;
+	return CPU_COUNT(&set);
+}
+
+/* Pin a thread to the n-th allowed CPU (modulo their count), so that
+ * concurrency tests run truly parallel when there are several */
+static inline void hostPinThread(std::thread& thread, unsigned n)
+{
+	cpu_set_t allowed, one;
+	unsigned found = 0;
+
+	if (0 != sched_getaffinity(0, sizeof(allowed), &allowed))
+		return;
+	n %= CPU_COUNT(&allowed);
+	CPU_ZERO(&one);
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+	{
+		if (CPU_ISSET(cpu, &allowed) && (found++ == n))
+		{
+			CPU_SET(cpu, &one);
+			pthread_setaffinity_np(thread.native_handle(), sizeof(one), &one);
+			return;
+		}
+	}
+}
+
+#endif
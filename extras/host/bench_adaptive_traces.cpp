@@ -0,0 +1,98 @@
+/*
+ * Adaptive read interval on a simulated room: reads saved against a fixed
+ * 2 s interval, and the lag to see a door opening.
+ * 24 h of virtual time, 21.5*C with a slow daily swing and 12 random door
+ * openings (-3*C, 60 s fall, 10 min recovery), 0.03*C sensor noise, polled
+ * every 250 ms. Lag: from the true value first dropping 0.5*C to a read
+ * showing the drop.
+ */
+#include "DHT.h"
+#include "HostTest.h"
+#include <random>
+#include <vector>
+
+#define DAY_MS 86400000L
+#define POLL_MS 250
+#define DROP_C 0.5
+
+static std::vector<double> s_doors;
+
+static double roomTemp(double t)
+{
+	double v = 21.5 + 0.3 * sin(2 * M_PI * t / 86400);
+
+	for (size_t i = 0; i < s_doors.size(); i++)
+	{
+		if (t >= s_doors[i])
+		{
+			double d = t - s_doors[i];
+			v -= 3 * (1 - exp(-d / 60)) * exp(-d / 600);
+		}
+	}
+	return v;
+}
+
+int main()
+{
+	static const uint16_t kCeilings[] = {0, 8000, 16000, 32000, 60000};
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<double> when(0, 86400);
+
+	for (int i = 0; i < 12; i++)
+		s_doors.push_back(when(rng));
+
+	printf("ceiling   reads  of fixed  snap backs  lag mean / worst\n");
+	for (uint8_t c = 0; c < sizeof(kCeilings) / sizeof(kCeilings[0]); c++)
+	{
+		std::mt19937 noiseRng(1);
+		std::normal_distribution<double> noise(0, 0.03);
+		std::vector<double> seen(s_doors.size(), -1);
+		double lagSum = 0, lagWorst = 0;
+
+		g_hostMillis = 0;
+		DHT dht(2, DHT22);
+		dht.begin();
+		if (kCeilings[c])
+			dht.setAdaptiveInterval(kCeilings[c], 0.2f, 1.0f);
+
+		for (long ms = 0; ms < DAY_MS; ms += POLL_MS)
+		{
+			double t = ms / 1000.0;
+			TempAndHumidity th;
+			uint32_t reads = dht.getReadIntervalStats().reads;
+
+			g_hostMillis = ms;
+			hostSetReading(roomTemp(t) + noise(noiseRng), 45);
+			dht.readTempAndHumidity(th);
+			if (reads == dht.getReadIntervalStats().reads)
+				continue;
+
+			for (size_t i = 0; i < s_doors.size(); i++)
+			{
+				if ((seen[i] < 0) && (t >= s_doors[i]) && (roomTemp(s_doors[i]) - th.temp > DROP_C))
+					seen[i] = t - s_doors[i];
+			}
+		}
+
+		for (size_t i = 0; i < s_doors.size(); i++)
+		{
+			double cross = 0, lag;
+			while (roomTemp(s_doors[i]) - roomTemp(s_doors[i] + cross) <= DROP_C)
+				cross += 0.05;
+			lag = seen[i] - cross;
+			lagSum += lag;
+			if (lag > lagWorst)
+				lagWorst = lag;
+		}
+
+		const ReadIntervalStats& stats = dht.getReadIntervalStats();
+		if (kCeilings[c])
+			printf("%5us ", kCeilings[c] / 1000);
+		else
+			printf("fixed  ");
+		printf("%7u  %6.0f%%  %10u  %5.1f s / %5.1f s\n", stats.reads,
+			   100.0 * stats.reads / (DAY_MS / READ_INTERVAL_DHT22_DSHEET),
+			   stats.snapBacks, lagSum / s_doors.size(), lagWorst);
+	}
+	return 0;
+}
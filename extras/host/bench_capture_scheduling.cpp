@@ -0,0 +1,131 @@
+/*
+ * Capture scheduling against competing periodic "interrupt" load.
+ * One virtual hour of DHT22 reads every 2 s, 500 ms deadline. A capture
+ * collides if any load is busy during its CAPTURE_DURATION_MS; the ISR delay
+ * is the busy time spent behind the cli().
+ * Without scheduling, with a veto looking ahead over wakeup + capture, and
+ * with the host announcing each quiet gap as a window.
+ */
+#include "DHT.h"
+#include "HostTest.h"
+
+#define SIM_MS 3600000UL
+#define DEADLINE_MS 500
+
+//Periodic load: busy for busyMs every periodMs, starting at phaseMs
+struct Load
+{
+	unsigned long periodMs, busyMs, phaseMs;
+};
+
+static const Load* s_loads;
+static uint8_t s_loadCount;
+static unsigned long s_captures, s_collisions, s_delayMs;
+
+static bool busyAt(unsigned long t)
+{
+	for (uint8_t i = 0; i < s_loadCount; i++)
+	{
+		const Load& l = s_loads[i];
+		if ((t + l.periodMs - l.phaseMs) % l.periodMs < l.busyMs)
+			return true;
+	}
+	return false;
+}
+
+static void onCli()
+{
+	bool bHit = false;
+
+	s_captures++;
+	for (unsigned long t = g_hostMillis; t < g_hostMillis + CAPTURE_DURATION_MS; t++)
+	{
+		if (busyAt(t))
+		{
+			s_delayMs++;
+			bHit = true;
+		}
+	}
+	if (bHit)
+		s_collisions++;
+}
+
+static bool lookAheadVeto()
+{
+	for (unsigned long t = g_hostMillis; t < g_hostMillis + WAKEUP_DHT22 + CAPTURE_DURATION_MS; t++)
+	{
+		if (busyAt(t))
+			return true;
+	}
+	return false;
+}
+
+static void announceNextGap(DHT& dht)
+{
+	unsigned long start = g_hostMillis, end;
+
+	while (busyAt(start))
+		start++;
+	for (end = start; !busyAt(end) && (end - start < 1000); end++)
+		;
+	dht.announceQuietWindow(start, end - start);
+}
+
+enum Mode { ModeNone, ModeVeto, ModeWindows };
+
+static void run(const char* loadName, const Load* loads, uint8_t loadCount,
+				Mode mode, unsigned long loopMs)
+{
+	static const char* kModes[] = {"none", "veto", "windows"};
+
+	s_loads = loads;
+	s_loadCount = loadCount;
+	g_hostMillis = 12345;
+	hostSetReading(21.5f, 45.0f);
+
+	DHT dht(2, DHT22);
+	dht.begin();
+	if (ModeNone != mode)
+		dht.setCaptureScheduling(DEADLINE_MS, (ModeVeto == mode) ? lookAheadVeto : NULL);
+
+	s_captures = s_collisions = s_delayMs = 0;
+	for (unsigned long end = g_hostMillis + SIM_MS; g_hostMillis < end; g_hostMillis += loopMs)
+	{
+		if (ModeWindows == mode)
+			announceNextGap(dht);
+		dht.readTemperature();
+	}
+
+	const CaptureStats& stats = dht.getCaptureStats();
+	printf("%-9s %-7s loop %2lums: %4lu captures, %4lu collided (%5.1f%%), ISR delay %4lu ms",
+		   loadName, kModes[mode], loopMs, s_captures, s_collisions,
+		   100.0 * s_collisions / s_captures, s_delayMs);
+	if (ModeNone != mode)
+	{
+		printf(" | in window %4u, forced %4u, deferred calls %6u, wait avg %5.1f max %3u ms",
+			   stats.inWindow, stats.forced, stats.deferredCalls,
+			   stats.captures ? (double)stats.totalWaitMs / stats.captures : 0.0, stats.maxWaitMs);
+	}
+	printf("\n");
+}
+
+int main()
+{
+	//WiFi beacon + 50 Hz timer
+	static const Load kLight[] = {{102, 8, 0}, {20, 2, 7}};
+	//+ 100 Hz timer + audio DMA
+	static const Load kHeavy[] = {{102, 8, 0}, {10, 1, 3}, {33, 6, 11}};
+	//gaps of at most 4 ms, no capture fits
+	static const Load kSaturated[] = {{7, 3, 0}, {102, 20, 0}};
+
+	g_hostOnCli = onCli;
+	for (int mode = ModeNone; mode <= ModeWindows; mode++)
+		run("light", kLight, 2, (Mode)mode, 1);
+	for (int mode = ModeNone; mode <= ModeWindows; mode++)
+		run("light", kLight, 2, (Mode)mode, 10);
+	for (int mode = ModeNone; mode <= ModeWindows; mode++)
+		run("heavy", kHeavy, 3, (Mode)mode, 1);
+	for (int mode = ModeNone; mode <= ModeWindows; mode++)
+		run("saturated", kSaturated, 2, (Mode)mode, 1);
+	return 0;
+}
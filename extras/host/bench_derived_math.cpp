@@ -0,0 +1,76 @@
+/*
+ * Dew point, heat index and comfort ratio computed in float and in double:
+ * cost per call and worst difference from double, 1M random samples
+ * -10..40*C, 5..100%RH. Source of the DHT_DOUBLE_MATH figures.
+ * Only meaningful relative to each other on a host with an FPU; on soft-float
+ * targets (ESP8266) double costs a lot more.
+ */
+#include "DHT.h"
+#include "HostTest.h"
+#include <stdlib.h>
+
+#define SAMPLES 1000000
+
+static float s_temp[SAMPLES], s_humid[SAMPLES];
+
+template<typename T>
+static void run(const char* name)
+{
+	static const char* kDew[] = {"DEW_ACCURATE", "DEW_FAST", "DEW_ACCURATE_FAST", "DEW_FASTEST"};
+	static const char* kHeat[] = {"HEAT_NWS", "HEAT_STEADMAN", "HEAT_TABLE"};
+	volatile T sink = 0;
+	double start, us;
+
+	for (uint8_t alg = DEW_ACCURATE; alg <= DEW_FASTEST; alg++)
+	{
+		double maxDiff = 0;
+
+		start = hostNowUs();
+		for (int i = 0; i < SAMPLES; i++)
+			sink = sink + DHT::computeDewPoint<T>(alg, s_temp[i], s_humid[i]);
+		us = (hostNowUs() - start) / SAMPLES;
+
+		for (int i = 0; i < SAMPLES; i++)
+		{
+			double d = fabs((double)DHT::computeDewPoint<T>(alg, s_temp[i], s_humid[i]) -
+							DHT::computeDewPoint<double>(alg, s_temp[i], s_humid[i]));
+			if (d > maxDiff)
+				maxDiff = d;
+		}
+		printf("%s %-17s %.4f us/call, worst diff from double %.5f *C\n",
+			   name, kDew[alg], us, maxDiff);
+	}
+
+	for (uint8_t alg = HEAT_NWS; alg <= HEAT_TABLE; alg++)
+	{
+		start = hostNowUs();
+		for (int i = 0; i < SAMPLES; i++)
+			sink = sink + DHT::computeHeatIndex<T>(alg, s_temp[i], s_humid[i]);
+		us = (hostNowUs() - start) / SAMPLES;
+		printf("%s %-17s %.4f us/call\n", name, kHeat[alg], us);
+	}
+
+	DHT dht(2, DHT22);
+	ComfortProfile profile = dht.getComfortProfile();
+	ComfortState state;
+
+	start = hostNowUs();
+	for (int i = 0; i < SAMPLES; i++)
+		sink = sink + DHT::computeComfortRatio<T>(profile, state, s_temp[i], s_humid[i]);
+	us = (hostNowUs() - start) / SAMPLES;
+	printf("%s %-17s %.4f us/call\n", name, "comfort ratio", us);
+}
+
+int main()
+{
+	srand(1);
+	for (int i = 0; i < SAMPLES; i++)
+	{
+		s_temp[i] = -10 + 50.0f * rand() / RAND_MAX;
+		s_humid[i] = 5 + 95.0f * rand() / RAND_MAX;
+	}
+
+	run<float>("float ");
+	run<double>("double");
+	return 0;
+}
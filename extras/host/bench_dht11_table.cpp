@@ -0,0 +1,71 @@
+/*
+ * DHT11_LOOKUP: cost per call of dew point, heat index and comfort ratio read
+ * from the DHT11 table vs computed, 1M random DHT11 readings (integer
+ * 0..50*C, 20..90%RH). Source of the DHT11_LOOKUP figures.
+ * Flash cost: compare `size` of DHT.o built with -DDHT11_LOOKUP=0 and 1.
+ * On a host with an FPU the compute side is cheap, soft-float targets gain more.
+ */
+#include "DHT.h"
+#include "DHT11Table.h"
+#include "HostTest.h"
+#include <stdlib.h>
+
+#if !DHT11_LOOKUP
+#error "build with -DDHT11_LOOKUP=1"
+#endif
+
+#define SAMPLES 1000000
+
+static float s_temp[SAMPLES], s_humid[SAMPLES];
+
+int main()
+{
+	DHT dht(2, DHT11);
+	ComfortProfile profile = dht.getComfortProfile();
+	ComfortState state;
+	volatile float sink = 0;
+	double start, table, compute;
+
+	srand(1);
+	for (int i = 0; i < SAMPLES; i++)
+	{
+		s_temp[i] = rand() % 51;
+		s_humid[i] = 20 + rand() % 71;
+	}
+
+	printf("table: %u entries, %u bytes\n",
+		   (unsigned)(sizeof(s_dht11Table) / sizeof(s_dht11Table[0])),
+		   (unsigned)sizeof(s_dht11Table));
+
+	start = hostNowUs();
+	for (int i = 0; i < SAMPLES; i++)
+		sink = sink + dht.getDewPoint(DEW_ACCURATE_FAST, s_temp[i], s_humid[i]);
+	table = (hostNowUs() - start) * 1000 / SAMPLES;
+	start = hostNowUs();
+	for (int i = 0; i < SAMPLES; i++)
+		sink = sink + DHT::computeDewPoint<DHTScalar>(DEW_ACCURATE_FAST, s_temp[i], s_humid[i]);
+	compute = (hostNowUs() - start) * 1000 / SAMPLES;
+	printf("%-13s table %.1f ns/call, compute %.1f ns/call\n", "dew point", table, compute);
+
+	start = hostNowUs();
+	for (int i = 0; i < SAMPLES; i++)
+		sink = sink + dht.getHeatIndex(s_temp[i], s_humid[i]);
+	table = (hostNowUs() - start) * 1000 / SAMPLES;
+	start = hostNowUs();
+	for (int i = 0; i < SAMPLES; i++)
+		sink = sink + DHT::computeHeatIndex<DHTScalar>(HEAT_NWS, s_temp[i], s_humid[i]);
+	compute = (hostNowUs() - start) * 1000 / SAMPLES;
+	printf("%-13s table %.1f ns/call, compute %.1f ns/call\n", "heat index", table, compute);
+
+	start = hostNowUs();
+	for (int i = 0; i < SAMPLES; i++)
+		sink = sink + dht.getComfortRatio(state, s_temp[i], s_humid[i]);
+	table = (hostNowUs() - start) * 1000 / SAMPLES;
+	start = hostNowUs();
+	for (int i = 0; i < SAMPLES; i++)
+		sink = sink + DHT::computeComfortRatio<DHTScalar>(profile, state, s_temp[i], s_humid[i]);
+	compute = (hostNowUs() - start) * 1000 / SAMPLES;
+	printf("%-13s table %.1f ns/call, compute %.1f ns/call\n", "comfort ratio", table, compute);
+
+	return 0;
+}
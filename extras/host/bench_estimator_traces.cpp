@@ -0,0 +1,80 @@
+/*
+ * Trend filter (DHT_ESTIMATOR) on simulated room traces: RMS error of the
+ * estimate against holding the last read, for several read intervals.
+ * The real read path runs against the simulated DHT22 (0.05*C, 0.1%RH noise,
+ * 0.1 resolution), queried every second over 4 hours, the first 10 minutes
+ * are not scored. Rerun after changing the ESTIMATOR_* tuning.
+ */
+#include "DHT.h"
+#include "HostTest.h"
+#include <random>
+
+#define TRACE_SECONDS (4 * 3600L)
+#define WARMUP_SECONDS 600
+
+static double traceTemp(double t, int trace)
+{
+	switch (trace)
+	{
+		case 0: //HVAC cycle, 1*C amplitude, 30 min
+			return 22 + 1.0 * sin(2 * M_PI * t / 1800);
+		case 1: //heater switched on after 1h, +5*C, 10 min time constant
+			return 20 + (t > 3600 ? 5 * (1 - exp(-(t - 3600) / 600)) : 0);
+		default: //10 min and 2 h components
+			return 22 + 0.3 * sin(2 * M_PI * t / 600) + 0.5 * sin(2 * M_PI * t / 7200);
+	}
+}
+
+static double traceHumid(double t, int trace)
+{
+	return 45 + 5 * sin(2 * M_PI * t / 3600 + trace);
+}
+
+int main()
+{
+	static const char* kTraces[] = {"HVAC 1*C/30min", "heater +5*C", "mixed 10min+2h"};
+	static const uint16_t kIntervals[] = {2, 10, 30, 60};
+
+	printf("RMS error, estimate / last read. Temperature in *C, humidity in %%RH\n");
+	for (int trace = 0; trace < 3; trace++)
+	{
+		printf("%-15s", kTraces[trace]);
+		for (uint8_t iv = 0; iv < sizeof(kIntervals) / sizeof(kIntervals[0]); iv++)
+		{
+			std::mt19937 rng(1);
+			std::normal_distribution<double> noise(0, 0.05);
+			double seT = 0, seH = 0, seHoldT = 0, seHoldH = 0;
+			long count = 0;
+			TempAndHumidity est, held = {NAN, NAN};
+
+			g_hostMillis = 0;
+			DHT dht(2, DHT22, kIntervals[iv] * 1000);
+			dht.begin();
+
+			for (long t = 1; t < TRACE_SECONDS; t++)
+			{
+				g_hostMillis = t * 1000;
+				hostSetReading(traceTemp(t, trace) + noise(rng), traceHumid(t, trace) + 2 * noise(rng));
+
+				//read() delays a few ms, estimate for the query time
+				dht.readTempAndHumidity(held);
+				dht.estimateTempAndHumidity(est, t * 1000);
+
+				if (t > WARMUP_SECONDS)
+				{
+					double e;
+					e = est.temp - traceTemp(t, trace);		seT += e * e;
+					e = est.humid - traceHumid(t, trace);	seH += e * e;
+					e = held.temp - traceTemp(t, trace);	seHoldT += e * e;
+					e = held.humid - traceHumid(t, trace);	seHoldH += e * e;
+					count++;
+				}
+			}
+			printf(" | %2us T %.3f/%.3f H %.2f/%.2f", kIntervals[iv],
+				   sqrt(seT / count), sqrt(seHoldT / count),
+				   sqrt(seH / count), sqrt(seHoldH / count));
+		}
+		printf("\n");
+	}
+	return 0;
+}
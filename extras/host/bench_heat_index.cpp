@@ -0,0 +1,48 @@
+/*
+ * Heat index: cost per call and error against the double NWS procedure,
+ * 1M random samples -10..50*C, 0..100%RH. Source of the figures next to each
+ * algorithm in DHT::computeHeatIndex().
+ */
+#include "DHT.h"
+#include "HostTest.h"
+#include <stdlib.h>
+
+#define SAMPLES 1000000
+
+static float s_temp[SAMPLES], s_humid[SAMPLES];
+
+int main()
+{
+	static const char* kNames[] = {"HEAT_NWS", "HEAT_STEADMAN", "HEAT_TABLE"};
+
+	srand(1);
+	for (int i = 0; i < SAMPLES; i++)
+	{
+		s_temp[i] = -10 + 60.0f * rand() / RAND_MAX;
+		s_humid[i] = 100.0f * rand() / RAND_MAX;
+	}
+
+	for (uint8_t alg = HEAT_NWS; alg <= HEAT_TABLE; alg++)
+	{
+		volatile float sink = 0;
+		double meanErr = 0, maxErr = 0;
+
+		double start = hostNowUs();
+		for (int i = 0; i < SAMPLES; i++)
+			sink = sink + DHT::computeHeatIndex<DHTScalar>(alg, s_temp[i], s_humid[i]);
+		double us = (hostNowUs() - start) / SAMPLES;
+
+		for (int i = 0; i < SAMPLES; i++)
+		{
+			double e = DHT::computeHeatIndex<DHTScalar>(alg, s_temp[i], s_humid[i]) -
+					   DHT::computeHeatIndex<double>(HEAT_NWS, s_temp[i], s_humid[i]);
+			meanErr += e;
+			if (fabs(e) > fabs(maxErr))
+				maxErr = e;
+		}
+
+		printf("%-14s %.4f us/call, mean error %+.3f, worst %+.3f *C\n",
+			   kNames[alg], us, meanErr / SAMPLES, maxErr);
+	}
+	return 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * DHTReadingQueue throughput: one producer and one consumer thread pinned to
+ * different CPUs, the producer retries on a full queue. Records per second
+ * delivered for several capacities.
+ * Only meaningful with 2 or more CPUs, on one CPU it measures time slicing.
+ */
+#include "DHTReadingQueue.h"
+#include "HostTest.h"
+
+#define BENCH_RECORDS 20000000UL
+
+int main()
+{
+	static const uint16_t kCapacities[] = {8, 64, 1024};
+
+	printf("%u CPU(s)%s\n", hostCpuCount(),
+		   hostCpuCount() < 2 ? ", threads are time sliced, NOT parallel" : "");
+
+	for (uint8_t c = 0; c < sizeof(kCapacities) / sizeof(kCapacities[0]); c++)
+	{
+		DHTReading* storage = new DHTReading[kCapacities[c]];
+		DHTReadingQueue queue(storage, kCapacities[c]);
+		uint32_t fullPushes, emptyPops = 0;
+
+		double start = hostNowUs();
+		std::thread producer([&]
+		{
+			DHTReading r;
+			memset(&r, 0, sizeof(r));
+			for (uint32_t i = 0; i < BENCH_RECORDS; i++)
+			{
+				r.timeMs = i;
+				while (!queue.push(r))
+				{
+					if (hostCpuCount() < 2)
+						std::this_thread::yield();
+				}
+			}
+		});
+		std::thread consumer([&]
+		{
+			DHTReading r;
+			for (uint32_t got = 0; got < BENCH_RECORDS; )
+			{
+				if (queue.pop(r))
+					got++;
+				else
+				{
+					emptyPops++;
+					if (hostCpuCount() < 2)
+						std::this_thread::yield();
+				}
+			}
+		});
+		hostPinThread(producer, 0);
+		hostPinThread(consumer, 1);
+		producer.join();
+		consumer.join();
+		double seconds = (hostNowUs() - start) / 1e6;
+
+		fullPushes = queue.getOverflowCount();
+		printf("capacity %4u: %6.1f Mrec/s, %u full pushes, %u empty pops\n",
+			   kCapacities[c], BENCH_RECORDS / seconds / 1e6, fullPushes, emptyPops);
+		delete[] storage;
+	}
+	return 0;
+}
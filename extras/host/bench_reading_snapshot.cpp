@@ -0,0 +1,89 @@
+/*
+ * DHTReadingSnapshot: reader throughput as the number of reader threads grows,
+ * with the writer idle and with the writer publishing continuously.
+ * Each thread is pinned to its own CPU while there are enough of them.
+ * Only meaningful with several CPUs, on one CPU it measures time slicing.
+ */
+#include "DHTReadingSnapshot.h"
+#include "HostTest.h"
+
+#define BENCH_SECONDS 0.5
+
+static double run(DHTReadingSnapshot& snapshot, unsigned readerCount, bool bWriter,
+				  unsigned long& destPublishes)
+{
+	volatile bool bStop = false;
+	unsigned long reads[16] = {0};
+	std::thread* threads[17];
+	unsigned n = 0;
+
+	destPublishes = 0;
+	for (unsigned t = 0; t < readerCount; t++)
+	{
+		threads[n] = new std::thread([&, t]
+		{
+			DHTReading copy;
+			unsigned long count = 0;
+			while (!__atomic_load_n(&bStop, __ATOMIC_RELAXED))
+				count += snapshot.read(copy);
+			reads[t] = count;
+		});
+		hostPinThread(*threads[n], n + 1);
+		n++;
+	}
+	if (bWriter)
+	{
+		threads[n] = new std::thread([&]
+		{
+			DHTReading w;
+			memset(&w, 0, sizeof(w));
+			while (!__atomic_load_n(&bStop, __ATOMIC_RELAXED))
+			{
+				w.timeMs++;
+				snapshot.publish(w);
+				destPublishes++;
+			}
+		});
+		hostPinThread(*threads[n], 0);
+		n++;
+	}
+
+	double start = hostNowUs();
+	while (hostNowUs() - start < BENCH_SECONDS * 1e6)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	__atomic_store_n(&bStop, true, __ATOMIC_RELAXED);
+	double seconds = (hostNowUs() - start) / 1e6;
+
+	unsigned long total = 0;
+	for (unsigned t = 0; t < n; t++)
+	{
+		threads[t]->join();
+		delete threads[t];
+	}
+	for (unsigned t = 0; t < readerCount; t++)
+		total += reads[t];
+	destPublishes = (unsigned long)(destPublishes / seconds);
+	return total / seconds;
+}
+
+int main()
+{
+	DHTReadingSnapshot snapshot;
+	DHTReading r;
+	unsigned long publishes;
+
+	memset(&r, 0, sizeof(r));
+	snapshot.publish(r);
+
+	printf("%u CPU(s)%s\n", hostCpuCount(),
+		   hostCpuCount() < 2 ? ", threads are time sliced, NOT parallel" : "");
+
+	for (unsigned readers = 1; readers <= 8; readers *= 2)
+	{
+		double idle = run(snapshot, readers, false, publishes);
+		double busy = run(snapshot, readers, true, publishes);
+		printf("%u reader(s): %7.1f Mreads/s writer idle, %7.1f Mreads/s with %.1f Mpublishes/s\n",
+			   readers, idle / 1e6, busy / 1e6, publishes / 1e6);
+	}
+	return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * getTelemetry() against snprintf with %f for the same CSV line, 1M lines.
+ * The snprintf figures include or exclude computing the derived values.
+ */
+#include "DHT.h"
+#include "HostTest.h"
+
+#define LINES 1000000
+
+int main()
+{
+	DHT dht(2, DHT22);
+	char line[TELEMETRY_MAX_LEN];
+	volatile unsigned sink = 0;
+	double start, encoder, encoderTH, printfOnly, printfDerived, printfTH;
+
+	hostSetReading(23.4f, 45.6f);
+	dht.begin();
+
+	float t = dht.readTemperature(), h = dht.readHumidity();
+	float hi = dht.getHeatIndex(), dp = dht.getDewPoint();
+	ComfortState state;
+	float cr = dht.getComfortRatio(state);
+	ComfortProfile profile = dht.getComfortProfile();
+
+	start = hostNowUs();
+	for (int i = 0; i < LINES; i++)
+		sink = sink + dht.getTelemetry(line, sizeof(line), TELEMETRY_CSV);
+	encoder = (hostNowUs() - start) / LINES;
+
+	start = hostNowUs();
+	for (int i = 0; i < LINES; i++)
+		sink = sink + snprintf(line, sizeof(line), "%.1f,%.1f,%.2f,%.2f,%.2f,%s\n",
+							   h, t, hi, dp, cr, DHT::getComfortStateName(state));
+	printfOnly = (hostNowUs() - start) / LINES;
+
+	start = hostNowUs();
+	for (int i = 0; i < LINES; i++)
+	{
+		float ratio = DHT::computeComfortRatio<float>(profile, state, t, h);
+		sink = sink + snprintf(line, sizeof(line), "%.1f,%.1f,%.2f,%.2f,%.2f,%s\n", h, t,
+							   DHT::computeHeatIndex<float>(HEAT_NWS, t, h),
+							   DHT::computeDewPoint<float>(DEW_ACCURATE_FAST, t, h),
+							   ratio, DHT::getComfortStateName(state));
+	}
+	printfDerived = (hostNowUs() - start) / LINES;
+
+	start = hostNowUs();
+	for (int i = 0; i < LINES; i++)
+		sink = sink + dht.getTelemetry(line, sizeof(line), TELEMETRY_CSV,
+									   TELEMETRY_HUMIDITY | TELEMETRY_TEMPERATURE);
+	encoderTH = (hostNowUs() - start) / LINES;
+
+	start = hostNowUs();
+	for (int i = 0; i < LINES; i++)
+		sink = sink + snprintf(line, sizeof(line), "%.1f,%.1f\n", h, t);
+	printfTH = (hostNowUs() - start) / LINES;
+
+	printf("all fields: getTelemetry %.3f us, snprintf %.3f us (%.3f us with derived values)\n",
+		   encoder, printfOnly, printfDerived);
+	printf("humidity + temperature: getTelemetry %.3f us, snprintf %.3f us\n",
+		   encoderTH, printfTH);
+	return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Adaptive read interval: doubling up to the ceiling, snap back on change,
+ * comfort change and error, never below the minimum interval.
+ */
+#include "DHT.h"
+#include "HostTest.h"
+
+//Advance virtual time to the next due read and read
+static void nextRead(DHT& dht)
+{
+	g_hostMillis += dht.getReadInterval();
+	dht.readTemperature();
+}
+
+int main()
+{
+	DHT dht(2, DHT22);
+
+	g_hostMillis = 0;
+	hostSetReading(21.0f, 45.0f);
+	dht.begin();
+	dht.setAdaptiveInterval(16000);
+	HOST_CHECK(READ_INTERVAL_DHT22_DSHEET == dht.getReadInterval());
+
+	//Stable: 2, 4, 8, 16, then stays at the ceiling
+	dht.readTemperature();
+	for (uint16_t expected = 4000; expected <= 16000; expected *= 2)
+	{
+		nextRead(dht);
+		HOST_CHECK(expected == dht.getReadInterval());
+	}
+	nextRead(dht);
+	HOST_CHECK(16000 == dht.getReadInterval());
+
+	//Requests before the interval elapsed are answered from the cache
+	uint32_t reads = dht.getReadIntervalStats().reads;
+	g_hostMillis += 1000;
+	dht.readTemperature();
+	HOST_CHECK(reads == dht.getReadIntervalStats().reads);
+
+	//A change above the delta snaps back
+	hostSetReading(21.5f, 45.0f);
+	nextRead(dht);
+	HOST_CHECK(READ_INTERVAL_DHT22_DSHEET == dht.getReadInterval());
+	HOST_CHECK(1 == dht.getReadIntervalStats().snapBacks);
+
+	//So does a read error
+	nextRead(dht);
+	HOST_CHECK(4000 == dht.getReadInterval());
+	g_hostSensor = false;
+	nextRead(dht);
+	g_hostSensor = true;
+	HOST_CHECK(READ_INTERVAL_DHT22_DSHEET == dht.getReadInterval());
+
+	//And a comfort state change, even for a change below the delta.
+	//Too hot starts above 28.575*C at 45%
+	hostSetReading(28.5f, 45.0f);
+	nextRead(dht);
+	nextRead(dht);
+	HOST_CHECK(4000 == dht.getReadInterval());
+	hostSetReading(28.6f, 45.0f);
+	nextRead(dht);
+	HOST_CHECK(READ_INTERVAL_DHT22_DSHEET == dht.getReadInterval());
+
+	//A ceiling below the datasheet minimum never reads faster than it
+	dht.setAdaptiveInterval(500);
+	for (int i = 0; i < 4; i++)
+	{
+		nextRead(dht);
+		HOST_CHECK(READ_INTERVAL_DHT22_DSHEET == dht.getReadInterval());
+	}
+
+	return HOST_RESULT();
+}
@@ -0,0 +1,81 @@
+/*
+ * begin() on a DHT_AUTO sensor with a queue, snapshot and rollup attached:
+ * the detection read is published once, decoded with the detected type.
+ */
+#include "DHTReadingQueue.h"
+#include "DHTReadingSnapshot.h"
+#include "DHTRollup.h"
+#include "HostTest.h"
+
+static RollupBucket s_lastBucket;
+static unsigned long s_buckets = 0;
+
+static void keepBucket(uint8_t, const RollupBucket& bucket)
+{
+	s_lastBucket = bucket;
+	s_buckets++;
+}
+
+int main()
+{
+	DHTReading storage[4], r;
+
+	//DHT22 answers the detection read
+	{
+		DHTReadingQueue queue(storage, 4);
+		DHTReadingSnapshot snapshot;
+		RollupTier tiers[1];
+		tiers[0].periodMs = 60000UL;
+		DHTRollup rollup(tiers, 1, keepBucket);
+		DHT dht(2);
+
+		dht.setReadingQueue(&queue);
+		dht.setReadingSnapshot(&snapshot);
+		dht.setRollup(&rollup);
+		g_hostSensor = true;
+		hostSetReading(23.4f, 55.0f);
+		dht.begin();
+
+		HOST_CHECK(READ_INTERVAL_DHT22_DSHEET == dht.getReadInterval());
+		HOST_CHECK(1 == queue.size());
+		HOST_CHECK(queue.pop(r) && errDHT_OK == r.error && 1 == r.seq);
+		HOST_CHECK_NEAR(r.temp, 23.4, 1e-4);
+		HOST_CHECK(55.0f == r.humid);
+		HOST_CHECK(snapshot.read(r) && errDHT_OK == r.error && 1 == r.seq);
+		HOST_CHECK_NEAR(r.temp, 23.4, 1e-4);
+		HOST_CHECK(55.0f == r.humid);
+
+		rollup.flush();
+		HOST_CHECK(1 == s_buckets && 1 == s_lastBucket.count);
+		HOST_CHECK(1 == s_lastBucket.temp.count && 1 == s_lastBucket.dew.count);
+		HOST_CHECK_NEAR(s_lastBucket.temp.getMean(), 23.4, 1e-4);
+	}
+
+	//No answer: one failed record, nothing rolled up
+	{
+		DHTReadingQueue queue(storage, 4);
+		DHTReadingSnapshot snapshot;
+		RollupTier tiers[1];
+		tiers[0].periodMs = 60000UL;
+		DHTRollup rollup(tiers, 1, keepBucket);
+		DHT dht(2);
+
+		dht.setReadingQueue(&queue);
+		dht.setReadingSnapshot(&snapshot);
+		dht.setRollup(&rollup);
+		g_hostSensor = false;
+		s_buckets = 0;
+		dht.begin();
+		g_hostSensor = true;
+
+		HOST_CHECK(1 == queue.size());
+		HOST_CHECK(queue.pop(r) && errDHT_OK != r.error && 1 == r.seq);
+		HOST_CHECK(isnan(r.temp) && isnan(r.humid));
+		HOST_CHECK(snapshot.read(r) && errDHT_OK != r.error && 1 == r.seq);
+
+		rollup.flush();
+		HOST_CHECK(0 == s_buckets);
+	}
+
+	return HOST_RESULT();
+}
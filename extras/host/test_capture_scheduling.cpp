@@ -0,0 +1,87 @@
+/*
+ * Capture scheduling: window alignment by stretching the wakeup pulse,
+ * veto, deadline, stale windows.
+ */
+#include "DHT.h"
+#include "HostTest.h"
+
+static unsigned long s_cliMs;
+static void onCli()
+{
+	s_cliMs = g_hostMillis;
+}
+
+static bool s_bVeto;
+static bool veto()
+{
+	return s_bVeto;
+}
+
+int main()
+{
+	DHT dht(2, DHT22);
+	unsigned long due;
+
+	g_hostOnCli = onCli;
+	hostSetReading(21.0f, 45.0f);
+	g_hostMillis = 10000;
+	dht.begin();
+	dht.readTemperature();
+	dht.setCaptureScheduling(500, veto);
+
+	//Window too far: deferred, answered from the cache
+	due = g_hostMillis += READ_INTERVAL_DHT22_DSHEET;
+	dht.announceQuietWindow(due + 50, 20);
+	s_cliMs = 0;
+	HOST_CHECK(21.0f == dht.readTemperature());
+	HOST_CHECK(0 == s_cliMs && 1 == dht.getCaptureStats().deferredCalls);
+
+	//Close enough: the wakeup pulse is stretched to start the capture with it
+	g_hostMillis = due + 45;
+	dht.readTemperature();
+	HOST_CHECK(due + 50 == s_cliMs);
+	HOST_CHECK(1 == dht.getCaptureStats().captures && 1 == dht.getCaptureStats().inWindow);
+	HOST_CHECK(45 == dht.getCaptureStats().maxWaitMs);
+
+	//Veto, then the deadline
+	due = g_hostMillis += READ_INTERVAL_DHT22_DSHEET;
+	dht.announceQuietWindow(due, 100);
+	s_bVeto = true;
+	s_cliMs = 0;
+	for (; g_hostMillis < due + 500; g_hostMillis += 10)
+		dht.readTemperature();
+	HOST_CHECK(0 == s_cliMs);
+	dht.readTemperature();
+	HOST_CHECK(due + 500 + WAKEUP_DHT22 == s_cliMs);
+	HOST_CHECK(1 == dht.getCaptureStats().forced && 500 == dht.getCaptureStats().maxWaitMs);
+	s_bVeto = false;
+
+	//A stale window defers until the deadline...
+	due = g_hostMillis += READ_INTERVAL_DHT22_DSHEET;
+	s_cliMs = 0;
+	dht.readTemperature();
+	HOST_CHECK(0 == s_cliMs);
+
+	//...unless cleared
+	dht.clearQuietWindows();
+	due = ++g_hostMillis;
+	dht.readTemperature();
+	HOST_CHECK(due + WAKEUP_DHT22 == s_cliMs);
+
+	//setCaptureScheduling() clears them too
+	dht.announceQuietWindow(0, 10);
+	dht.setCaptureScheduling(500);
+	due = g_hostMillis += READ_INTERVAL_DHT22_DSHEET;
+	s_cliMs = 0;
+	dht.readTemperature();
+	HOST_CHECK(due + WAKEUP_DHT22 == s_cliMs);
+
+	//Off: captures at once
+	dht.setCaptureScheduling(0);
+	dht.announceQuietWindow(g_hostMillis + 1000000UL, 10);
+	due = g_hostMillis += READ_INTERVAL_DHT22_DSHEET;
+	dht.readTemperature();
+	HOST_CHECK(due + WAKEUP_DHT22 == s_cliMs);
+
+	return HOST_RESULT();
+}
@@ -0,0 +1,81 @@
+/*
+ * DHT11_LOOKUP: every (temp, humidity) pair of the DHT11 table against the
+ * double computation, and setComfortProfile() turning the comfort lookup off.
+ */
+#include "DHT.h"
+#include "HostTest.h"
+
+#if !DHT11_LOOKUP
+#error "build with -DDHT11_LOOKUP=1"
+#endif
+
+//Table values are stored rounded to 0.1, a computed float almost never is
+static bool isTenth(double x)
+{
+	return fabs(x * 10 - floor(x * 10 + 0.5)) < 1e-3;
+}
+
+int main()
+{
+	DHT dht(2, DHT11);
+	ComfortProfile profile = dht.getComfortProfile();
+	ComfortState state, expectedState;
+	double maxDew = 0, maxHeat = 0, maxComfort = 0;
+	int entries = 0, stateDiffs = 0, notTable = 0;
+
+	for (int t = 0; t <= 50; t++)
+	{
+		for (int rh = 20; rh <= 90; rh++)
+		{
+			double dew = dht.getDewPoint(DEW_ACCURATE_FAST, t, rh);
+			double heat = dht.getHeatIndex(t, rh);
+			double ratio = dht.getComfortRatio(state, t, rh);
+			double expectedRatio = DHT::computeComfortRatio<double>(profile, expectedState, t, rh);
+
+			maxDew = fmax(maxDew, fabs(dew - DHT::computeDewPoint<double>(DEW_ACCURATE_FAST, t, rh)));
+			maxHeat = fmax(maxHeat, fabs(heat - DHT::computeHeatIndex<double>(HEAT_NWS, t, rh)));
+			maxComfort = fmax(maxComfort, fabs(ratio - expectedRatio));
+			if (state != expectedState)
+				stateDiffs++;
+			if (!isTenth(dew) || !isTenth(heat) || (ratio != floor(ratio)))
+				notTable++;
+			entries++;
+		}
+	}
+
+	printf("%d entries, worst diff from double: dew %.4f *C, heat index %.4f *C, comfort %.3f %%\n",
+		   entries, maxDew, maxHeat, maxComfort);
+	HOST_CHECK(3621 == entries);
+	HOST_CHECK(0 == notTable);
+	HOST_CHECK(maxDew <= 0.05 + 1e-4);
+	HOST_CHECK(maxHeat <= 0.05 + 1e-4);
+	HOST_CHECK(maxComfort <= 0.5 + 1e-4);
+	HOST_CHECK(0 == stateDiffs);
+
+	//Outside the table or not an integer: computed
+	HOST_CHECK(!isTenth(dht.getDewPoint(DEW_ACCURATE_FAST, 25.55f, 50)));
+	HOST_CHECK_NEAR(dht.getDewPoint(DEW_ACCURATE_FAST, 25, 95),
+					DHT::computeDewPoint<float>(DEW_ACCURATE_FAST, 25, 95), 1e-6);
+
+	//Another profile: comfort is computed with it, not read from the table
+	profile.m_tooHot_b -= 1.5f;
+	dht.setComfortProfile(profile);
+	int profileDiffs = 0;
+	for (int t = 0; t <= 50; t++)
+	{
+		for (int rh = 20; rh <= 90; rh++)
+		{
+			float ratio = dht.getComfortRatio(state, t, rh);
+			float expectedRatio = DHT::computeComfortRatio<float>(profile, expectedState, t, rh);
+
+			if ((ratio != expectedRatio) || (state != expectedState))
+				profileDiffs++;
+		}
+	}
+	HOST_CHECK(0 == profileDiffs);
+
+	//Dew point and heat index don't depend on the profile, still from the table
+	HOST_CHECK(isTenth(dht.getDewPoint(DEW_ACCURATE_FAST, 23, 47)));
+
+	return HOST_RESULT();
+}
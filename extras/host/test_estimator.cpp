@@ -0,0 +1,33 @@
+/*
+ * Trend filter (DHT_ESTIMATOR): follows a ramp between rare reads.
+ */
+#include "DHT.h"
+#include "HostTest.h"
+
+int main()
+{
+	DHT dht(2, DHT22, 30000);
+	TempAndHumidity est, sigma;
+
+	g_hostMillis = 0;
+	hostSetReading(20.0f, 50.0f);
+	dht.begin();
+	HOST_CHECK(!dht.estimateTempAndHumidity(est, 0));
+
+	//+1*C and -2%RH per 10 min, read every 30 s for an hour
+	for (long t = 0; t <= 3600; t += 30)
+	{
+		g_hostMillis = t * 1000;
+		hostSetReading(20.0f + t / 600.0f, 50.0f - t / 300.0f);
+		HOST_CHECK(dht.readEstimatedTempAndHumidity(est, &sigma));
+	}
+
+	//15 s after the last read, half way to the next one
+	HOST_CHECK(dht.estimateTempAndHumidity(est, 3615000UL, &sigma));
+	HOST_CHECK_NEAR(est.temp, 20.0 + 3615 / 600.0, 0.05);
+	HOST_CHECK_NEAR(est.humid, 50.0 - 3615 / 300.0, 0.1);
+	HOST_CHECK(sigma.temp > 0 && sigma.temp < 0.1);
+	HOST_CHECK(sigma.humid > 0 && sigma.humid < 0.2);
+
+	return HOST_RESULT();
+}
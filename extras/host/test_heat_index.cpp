@@ -0,0 +1,86 @@
+/*
+ * Heat index: argument order, algorithms against a double NWS reference.
+ */
+#include "DHT.h"
+#include "HostTest.h"
+
+//NWS procedure in double, straight from the published equations
+static double nwsReference(double c, double rh)
+{
+	double t = c * 1.8 + 32;
+	double hi = 0.5 * (t + 61.0 + ((t - 68.0) * 1.2) + (rh * 0.094));
+
+	if ((hi + t) / 2 >= 80)
+	{
+		hi = -42.379 + 2.04901523 * t + 10.14333127 * rh - .22475541 * t * rh -
+			 .00683783 * t * t - .05481717 * rh * rh + .00122874 * t * t * rh +
+			 .00085282 * t * rh * rh - .00000199 * t * t * rh * rh;
+		if (rh < 13 && t >= 80 && t <= 112)
+			hi -= ((13 - rh) / 4) * sqrt((17 - fabs(t - 95.)) / 17);
+		else if (rh > 85 && t >= 80 && t <= 87)
+			hi += ((rh - 85) / 10) * ((87 - t) / 5);
+	}
+	return (hi - 32) / 1.8;
+}
+
+int main()
+{
+	DHT dht(2, DHT22);
+
+	//The pre-existing (temp, humidity) call keeps its meaning
+	HOST_CHECK_NEAR(dht.getHeatIndex(30.0f, 60.0f), nwsReference(30, 60), 0.01);
+	HOST_CHECK_NEAR(dht.getHeatIndex(30.0f, 60.0f), 32.83, 0.01);
+	HOST_CHECK_NEAR(dht.getHeatIndex(30.0f, 60.0f, true), 32.83 * 1.8 + 32, 0.02);
+	HOST_CHECK_NEAR(dht.getHeatIndexAlg(HEAT_NWS, 30.0f, 60.0f), 32.83, 0.01);
+
+	//Default arguments read the sensor
+	hostSetReading(30.0f, 60.0f);
+	dht.begin();
+	HOST_CHECK_NEAR(dht.getHeatIndex(), 32.83, 0.01);
+
+	//Each algorithm over the grid, within its documented error. -1 is
+	//LAST_VALUE, skipped
+	double maxNws = 0, maxTable = 0, maxSteadmanCool = 0;
+	for (float t = -10; t <= 50; t += 0.5f)
+	{
+		for (float h = 0; h <= 100; h += 1)
+		{
+			if (LAST_VALUE == t)
+				continue;
+
+			double ref = nwsReference(t, h);
+			double e;
+
+			e = fabs(dht.getHeatIndexAlg(HEAT_NWS, t, h) - ref);
+			if (e > maxNws)
+				maxNws = e;
+
+			e = fabs(dht.getHeatIndexAlg(HEAT_TABLE, t, h) - ref);
+			if (e > maxTable)
+				maxTable = e;
+
+			//Steadman is the NWS procedure until the average reaches 80*F
+			if (t < 26)
+			{
+				e = fabs(dht.getHeatIndexAlg(HEAT_STEADMAN, t, h) - ref);
+				if (e > maxSteadmanCool)
+					maxSteadmanCool = e;
+			}
+		}
+	}
+	printf("worst error: NWS %.4f, table %.3f, Steadman below 26*C %.4f\n",
+		   maxNws, maxTable, maxSteadmanCool);
+	HOST_CHECK(maxNws < 0.01);
+	HOST_CHECK(maxTable < 1.5);
+	HOST_CHECK(maxSteadmanCool < 0.01);
+
+	//NAN in, NAN out, ex a failed read with NO_AUTOREFRESH
+	for (uint8_t alg = HEAT_NWS; alg <= HEAT_TABLE; alg++)
+	{
+		HOST_CHECK(isnan(dht.getHeatIndexAlg(alg, NAN, 50.0f)));
+		HOST_CHECK(isnan(dht.getHeatIndexAlg(alg, 30.0f, NAN)));
+		HOST_CHECK(isnan(dht.getHeatIndexAlg(alg, NAN, NAN)));
+	}
+
+	return HOST_RESULT();
+}
@@ -0,0 +1,24 @@
+/*
+ * DHTMath<float> with avr-libc's math.h, where the float functions are
+ * macros for the double ones (double is float on AVR).
+ */
+#include <math.h>
+#define logf log
+#define log10f log10
+#define powf pow
+#define sqrtf sqrt
+#define fabsf fabs
+
+#include "DHT.h"
+#include "HostTest.h"
+
+int main()
+{
+	HOST_CHECK_NEAR(DHTMath<float>::log(10.0f), 2.302585, 1e-5);
+	HOST_CHECK_NEAR(DHTMath<float>::log10(1000.0f), 3, 1e-5);
+	HOST_CHECK_NEAR(DHTMath<float>::pow(2.0f, 10.0f), 1024, 1e-3);
+	HOST_CHECK_NEAR(DHTMath<float>::sqrt(2.0f), 1.414214, 1e-5);
+	HOST_CHECK_NEAR(DHTMath<float>::fabs(-3.5f), 3.5, 0);
+
+	return HOST_RESULT();
+}
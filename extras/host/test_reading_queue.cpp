@@ -0,0 +1,130 @@
+/*
+ * DHTReadingQueue: capacity handling, FIFO and overflow, the read() path,
+ * and a producer / consumer contention test on separate CPUs.
+ */
+#include "DHTReadingQueue.h"
+#include "HostTest.h"
+
+#define STRESS_RECORDS 2000000UL
+
+static bool stress(uint16_t capacity, bool bRetry)
+{
+	DHTReading* storage = new DHTReading[capacity];
+	DHTReadingQueue queue(storage, capacity);
+	volatile bool bDone = false;
+	uint32_t popped = 0, bad = 0;
+
+	std::thread producer([&]
+	{
+		DHTReading r;
+		memset(&r, 0, sizeof(r));
+		for (uint32_t i = 0; i < STRESS_RECORDS; i++)
+		{
+			//every field derived from i, a torn record can not pass the check
+			r.timeMs = i;
+			r.seq = (uint16_t)i;
+			r.raw[0] = (uint8_t)i;
+			r.raw[4] = (uint8_t)(i >> 8);
+			r.temp = (float)i;
+			r.humid = -(float)i;
+			while (!queue.push(r) && bRetry)
+				std::this_thread::yield();
+		}
+		__atomic_store_n(&bDone, true, __ATOMIC_RELEASE);
+	});
+
+	std::thread consumer([&]
+	{
+		DHTReading r;
+		long last = -1;
+		for (;;)
+		{
+			if (queue.pop(r))
+			{
+				if (((long)r.timeMs <= last) || (r.seq != (uint16_t)r.timeMs) ||
+					(r.raw[0] != (uint8_t)r.timeMs) || (r.raw[4] != (uint8_t)(r.timeMs >> 8)) ||
+					(r.temp != (float)r.timeMs) || (r.humid != -(float)r.timeMs))
+				{
+					bad++;
+				}
+				last = r.timeMs;
+				popped++;
+			}
+			else if (__atomic_load_n(&bDone, __ATOMIC_ACQUIRE) && (0 == queue.size()))
+				break;
+			else
+				std::this_thread::yield();
+		}
+	});
+
+	hostPinThread(producer, 0);
+	hostPinThread(consumer, 1);
+	producer.join();
+	consumer.join();
+
+	//A retried push that found the queue full is counted as dropped too
+	bool bOk = (0 == bad);
+	if (bRetry)
+		bOk = bOk && (STRESS_RECORDS == popped);
+	else
+		bOk = bOk && (STRESS_RECORDS == popped + queue.getOverflowCount());
+
+	printf("capacity %5u %s: %lu offered, %u popped, %u full pushes, %u corrupt or out of order\n",
+		   capacity, bRetry ? "retry" : "drop ", STRESS_RECORDS, popped,
+		   queue.getOverflowCount(), bad);
+	delete[] storage;
+	return bOk;
+}
+
+int main()
+{
+	DHTReading storage[8], r;
+
+	//Capacity rounded down to a power of 2, within the index range
+	HOST_CHECK(1 == DHTReadingQueue(storage, 1).getCapacity());
+	HOST_CHECK(4 == DHTReadingQueue(storage, 6).getCapacity());
+	HOST_CHECK(8 == DHTReadingQueue(storage, 8).getCapacity());
+	HOST_CHECK(512 == DHTReadingQueue(storage, 1000).getCapacity());
+	HOST_CHECK(QUEUE_MAX_CAPACITY == DHTReadingQueue(storage, 65535).getCapacity());
+
+	//Producer and consumer positions on their own cache lines
+	HOST_CHECK(sizeof(DHTReadingQueue) >= 3 * 64);
+
+	//FIFO, full queue drops and counts
+	DHTReadingQueue queue(storage, 6);
+	memset(&r, 0, sizeof(r));
+	for (uint16_t i = 0; i < 6; i++)
+	{
+		r.seq = i;
+		HOST_CHECK(queue.push(r) == (i < 4));
+	}
+	HOST_CHECK(4 == queue.size() && 2 == queue.getOverflowCount());
+	for (uint16_t i = 0; i < 4; i++)
+		HOST_CHECK(queue.pop(r) && i == r.seq);
+	HOST_CHECK(!queue.pop(r));
+
+	//Every read attempt, failed ones included
+	DHT dht(2, DHT22);
+	DHTReadingQueue reads(storage, 8);
+	dht.setReadingQueue(&reads);
+	hostSetReading(21.5f, 40.0f);
+	dht.begin();
+	dht.readHumidity();
+	g_hostMillis += 2000;
+	g_hostSensor = false;
+	dht.readHumidity();
+	g_hostSensor = true;
+	HOST_CHECK(reads.pop(r) && errDHT_OK == r.error && 21.5f == r.temp && 40.0f == r.humid);
+	HOST_CHECK(reads.pop(r) && errDHT_OK != r.error && isnan(r.temp));
+	HOST_CHECK(!reads.pop(r));
+
+	//Contention
+	printf("contention test on %u CPU(s)%s\n", hostCpuCount(),
+		   hostCpuCount() < 2 ? ", threads are time sliced, NOT parallel" : "");
+	HOST_CHECK(stress(8, true));
+	HOST_CHECK(stress(1024, true));
+	HOST_CHECK(stress(8, false));
+	HOST_CHECK(stress(1024, false));
+
+	return HOST_RESULT();
+}
@@ -0,0 +1,110 @@
+/*
+ * DHTReadingSnapshot: publish / read, the read() path, and a stress test with
+ * one writer and several reader threads on separate CPUs.
+ */
+#include "DHTReadingSnapshot.h"
+#include "HostTest.h"
+
+#define STRESS_PUBLISHES 2000000UL
+#define STRESS_READERS 3
+
+//Every field derived from i, a reading mixed from two publishes fails the check
+static void fill(DHTReading& r, uint32_t i)
+{
+	r.timeMs = i;
+	r.seq = (uint16_t)i;
+	r.error = (ErrorDHT)(i & 3);
+	for (uint8_t b = 0; b < 5; b++)
+		r.raw[b] = (uint8_t)(i >> b);
+	r.temp = (float)i;
+	r.humid = -(float)i;
+}
+
+static bool consistent(const DHTReading& r)
+{
+	DHTReading expected;
+	memset(&expected, 0, sizeof(expected));
+	fill(expected, r.timeMs);
+	return (r.seq == expected.seq) && (r.error == expected.error) &&
+		   (0 == memcmp(r.raw, expected.raw, sizeof(r.raw))) &&
+		   (r.temp == expected.temp) && (r.humid == expected.humid);
+}
+
+int main()
+{
+	DHTReadingSnapshot snapshot;
+	DHTReading r;
+
+	HOST_CHECK(!snapshot.tryRead(r) && !snapshot.read(r));
+	HOST_CHECK(0 == snapshot.getVersion());
+
+	memset(&r, 0, sizeof(r));
+	fill(r, 7);
+	snapshot.publish(r);
+	memset(&r, 0, sizeof(r));
+	HOST_CHECK(snapshot.read(r) && 7 == r.timeMs && consistent(r));
+	HOST_CHECK(1 == snapshot.getVersion());
+
+	//read() publishes every attempt
+	DHT dht(2, DHT22);
+	DHTReadingSnapshot last;
+	dht.setReadingSnapshot(&last);
+	hostSetReading(21.5f, 40.0f);
+	dht.begin();
+	dht.readTemperature();
+	HOST_CHECK(last.read(r) && errDHT_OK == r.error && 21.5f == r.temp && 40.0f == r.humid);
+
+	//Stress
+	unsigned long reads[STRESS_READERS] = {0}, torn[STRESS_READERS] = {0};
+	volatile bool bDone = false;
+	std::thread* readers[STRESS_READERS];
+
+	printf("stress test on %u CPU(s)%s\n", hostCpuCount(),
+		   hostCpuCount() < 2 ? ", threads are time sliced, NOT parallel" : "");
+
+	for (int t = 0; t < STRESS_READERS; t++)
+	{
+		readers[t] = new std::thread([&, t]
+		{
+			DHTReading copy;
+			uint32_t lastTime = 0;
+			while (!__atomic_load_n(&bDone, __ATOMIC_ACQUIRE))
+			{
+				if (snapshot.read(copy))
+				{
+					//never torn, never older than a previous read
+					if (!consistent(copy) || (copy.timeMs < lastTime))
+						torn[t]++;
+					lastTime = copy.timeMs;
+					reads[t]++;
+				}
+			}
+		});
+		hostPinThread(*readers[t], t + 1);
+	}
+
+	std::thread writer([&]
+	{
+		DHTReading w;
+		memset(&w, 0, sizeof(w));
+		for (uint32_t i = 8; i < 8 + STRESS_PUBLISHES; i++)
+		{
+			fill(w, i);
+			snapshot.publish(w);
+		}
+		__atomic_store_n(&bDone, true, __ATOMIC_RELEASE);
+	});
+	hostPinThread(writer, 0);
+	writer.join();
+
+	for (int t = 0; t < STRESS_READERS; t++)
+	{
+		readers[t]->join();
+		delete readers[t];
+		printf("reader %d: %lu reads, %lu torn or out of order\n", t, reads[t], torn[t]);
+		HOST_CHECK(0 == torn[t]);
+	}
+	HOST_CHECK(snapshot.read(r) && (7 + STRESS_PUBLISHES) == r.timeMs);
+
+	return HOST_RESULT();
+}
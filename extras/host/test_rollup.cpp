@@ -0,0 +1,133 @@
+/*
+ * DHTRollup with virtual time: every completed bucket of 3 tiers (minute,
+ * hour, day) is compared to a brute force computation over all samples.
+ * Irregular sample spacing, gaps of 2 hours, and NAN dew points.
+ */
+#include "DHTRollup.h"
+#include "HostTest.h"
+#include <vector>
+#include <random>
+
+#define SAMPLES 200000
+
+struct Sample
+{
+	unsigned long timeMs;
+	float temp, humid, dew;
+};
+
+static std::vector<Sample> s_samples;
+static const unsigned long kPeriods[] = {60000UL, 3600000UL, 86400000UL};
+static unsigned long s_buckets[3], s_mismatches;
+
+static bool statMatches(const RollupStat& stat, float Sample::* field,
+						unsigned long startMs, unsigned long periodMs)
+{
+	uint32_t count = 0;
+	double sum = 0;
+	float lo = NAN, hi = NAN, last = NAN;
+
+	for (size_t i = 0; i < s_samples.size(); i++)
+	{
+		const Sample& s = s_samples[i];
+		float v = s.*field;
+
+		if ((s.timeMs < startMs) || (s.timeMs - startMs >= periodMs) || isnan(v))
+			continue;
+		if (0 == count || v < lo)
+			lo = v;
+		if (0 == count || v > hi)
+			hi = v;
+		last = v;
+		sum += v;
+		count++;
+	}
+
+	if (0 == count)
+		return (0 == stat.count) && isnan(stat.min) && isnan(stat.max) && isnan(stat.getMean());
+	return (count == stat.count) && (fabs(sum - stat.sum) <= 1e-2 * count) &&
+		   (lo == stat.min) && (hi == stat.max) && (last == stat.last);
+}
+
+static void onBucket(uint8_t tier, const RollupBucket& bucket)
+{
+	uint32_t count = 0;
+
+	for (size_t i = 0; i < s_samples.size(); i++)
+	{
+		if ((s_samples[i].timeMs >= bucket.startMs) &&
+			(s_samples[i].timeMs - bucket.startMs < kPeriods[tier]))
+			count++;
+	}
+
+	s_buckets[tier]++;
+	if ((count != bucket.count) || (bucket.startMs % kPeriods[tier]) ||
+		!statMatches(bucket.temp, &Sample::temp, bucket.startMs, kPeriods[tier]) ||
+		!statMatches(bucket.humid, &Sample::humid, bucket.startMs, kPeriods[tier]) ||
+		!statMatches(bucket.dew, &Sample::dew, bucket.startMs, kPeriods[tier]))
+	{
+		if (s_mismatches++ < 5)
+			printf("mismatch: tier %u bucket %lu, %u samples\n", tier, bucket.startMs, bucket.count);
+	}
+}
+
+static RollupBucket s_lastBucket;
+static void keepBucket(uint8_t, const RollupBucket& bucket)
+{
+	s_lastBucket = bucket;
+}
+
+int main()
+{
+	RollupTier tiers[3];
+	for (uint8_t i = 0; i < 3; i++)
+		tiers[i].periodMs = kPeriods[i];
+	DHTRollup rollup(tiers, 3, onBucket);
+	std::mt19937 rng(3);
+	std::uniform_int_distribution<int> step(500, 5000);
+	std::uniform_real_distribution<float> value(15, 30);
+	unsigned long t = 12345;
+
+	for (int i = 0; i < SAMPLES; i++)
+	{
+		t += step(rng);
+		if (0 == i % 20000)
+			t += 7200000UL;
+
+		Sample s = {t, value(rng), value(rng), value(rng)};
+		//a run of failed dew points, long enough to empty whole minutes
+		if ((i % 5000) < 100)
+			s.dew = NAN;
+		s_samples.push_back(s);
+		rollup.add(s.timeMs, s.temp, s.humid, s.dew);
+	}
+	rollup.flush();
+
+	printf("%.1f virtual days, %d samples: %lu minute, %lu hour, %lu day buckets, %lu mismatches\n",
+		   t / 86400000.0, SAMPLES, s_buckets[0], s_buckets[1], s_buckets[2], s_mismatches);
+	HOST_CHECK(0 == s_mismatches);
+	HOST_CHECK(s_buckets[0] > 0 && s_buckets[1] > 0 && s_buckets[2] > 0);
+
+	//Through read(): RH 0 gives a NAN dew point that must not poison the bucket
+	RollupTier readTiers[1];
+	readTiers[0].periodMs = 10000UL;
+	DHTRollup readRollup(readTiers, 1, keepBucket);
+	DHT dht(2, DHT22);
+	dht.setRollup(&readRollup);
+	g_hostMillis = 0;
+	dht.begin();
+	for (int i = 0; i < 5; i++)
+	{
+		g_hostMillis = 2000UL * i;
+		hostSetReading(20.0f + i, i ? 50.0f : 0.0f);
+		dht.readTemperature();
+	}
+	readRollup.flush();
+	HOST_CHECK(5 == s_lastBucket.count);
+	HOST_CHECK(5 == s_lastBucket.temp.count && 20.0f == s_lastBucket.temp.min &&
+			   24.0f == s_lastBucket.temp.max);
+	HOST_CHECK(4 == s_lastBucket.dew.count && !isnan(s_lastBucket.dew.getMean()) &&
+			   !isnan(s_lastBucket.dew.min));
+
+	return HOST_RESULT();
+}
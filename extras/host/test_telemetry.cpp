@@ -0,0 +1,55 @@
+/*
+ * getTelemetry(): exact output of each format, dew point algorithm,
+ * field selection, buffer too small, failed read.
+ */
+#include "DHT.h"
+#include "HostTest.h"
+
+int main()
+{
+	DHT dht(2, DHT22);
+	char line[TELEMETRY_MAX_LEN];
+	uint16_t len;
+
+	hostSetReading(23.4f, 45.6f);
+	dht.begin();
+
+	len = dht.getTelemetry(line, sizeof(line), TELEMETRY_CSV);
+	HOST_CHECK(0 == strcmp(line, "45.6,23.4,22.99,11.01,100.00,Comfort_OK\n") ||
+			   (printf("%s", line), false));
+	HOST_CHECK(strlen(line) == len);
+
+	len = dht.getTelemetry(line, sizeof(line), TELEMETRY_JSON);
+	HOST_CHECK(0 == strcmp(line, "{\"humidity\":45.6,\"temperature\":23.4,\"heatIndex\":22.99,"
+		"\"dewPoint\":11.01,\"comfortRatio\":100.00,\"comfort\":\"Comfort_OK\"}\n") ||
+			   (printf("%s", line), false));
+
+	len = dht.getTelemetry(line, sizeof(line), TELEMETRY_INFLUX,
+						   TELEMETRY_TEMPERATURE | TELEMETRY_COMFORT_STATE);
+	HOST_CHECK(0 == strcmp(line, "dht,pin=2 temperature=23.4,comfort=\"Comfort_OK\"\n") ||
+			   (printf("%s", line), false));
+
+	//Dew point algorithm chosen by the caller
+	dht.getTelemetry(line, sizeof(line), TELEMETRY_CSV, TELEMETRY_DEW_POINT, DEW_ACCURATE);
+	char expected[16];
+	snprintf(expected, sizeof(expected), "%.2f\n", dht.getDewPoint(DEW_ACCURATE));
+	HOST_CHECK(0 == strcmp(line, expected) || (printf("%s", line), false));
+
+	//Negative values, no "-0.0"
+	hostSetReading(-0.0f, 99.9f);
+	g_hostMillis += 5000;
+	dht.getTelemetry(line, sizeof(line), TELEMETRY_CSV, TELEMETRY_HUMIDITY | TELEMETRY_TEMPERATURE);
+	HOST_CHECK(0 == strcmp(line, "99.9,0.0\n") || (printf("%s", line), false));
+
+	//Too small: empty line, no write past the end
+	line[10] = 'x';
+	HOST_CHECK(0 == dht.getTelemetry(line, 10, TELEMETRY_JSON));
+	HOST_CHECK(0 == line[0] && 'x' == line[10]);
+
+	//Failed read: nothing rendered
+	g_hostSensor = false;
+	g_hostMillis += 5000;
+	HOST_CHECK(0 == dht.getTelemetry(line, sizeof(line)));
+
+	return HOST_RESULT();
+}
@@ -0,0 +1,32 @@
+/*
+ * getTelemetry() with NO_AUTOREFRESH: a failed read leaves NAN values, which
+ * must render as missing, comfort included.
+ */
+#include "DHT.h"
+#include "HostTest.h"
+
+int main()
+{
+	DHT dht(2, DHT22);
+	char line[TELEMETRY_MAX_LEN];
+
+	HOST_CHECK(1 == NO_AUTOREFRESH);
+
+	g_hostSensor = false;
+	dht.begin();
+	dht.readTemperature();
+	HOST_CHECK(errDHT_OK != dht.getLastError());
+
+	dht.getTelemetry(line, sizeof(line), TELEMETRY_CSV);
+	HOST_CHECK(0 == strcmp(line, ",,,,,\n") || (printf("%s", line), false));
+
+	dht.getTelemetry(line, sizeof(line), TELEMETRY_JSON);
+	HOST_CHECK(0 == strcmp(line, "{\"humidity\":null,\"temperature\":null,\"heatIndex\":null,"
+		"\"dewPoint\":null,\"comfortRatio\":null,\"comfort\":null}\n") ||
+			   (printf("%s", line), false));
+
+	//No valid field at all: no line
+	HOST_CHECK(0 == dht.getTelemetry(line, sizeof(line), TELEMETRY_INFLUX));
+
+	return HOST_RESULT();
+}